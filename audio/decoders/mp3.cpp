@@ -24,6 +24,7 @@
 
 #ifdef USE_MAD
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/ptr.h"
 #include "common/stream.h"
@@ -61,6 +62,27 @@ protected:
 	Timestamp _length;
 	mad_timer_t _totalTime;
 
+	/**
+	 * Position of a frame header inside the input stream, together with the
+	 * playback time at which that frame starts.
+	 */
+	struct FrameIndexEntry {
+		uint32 offset;
+		mad_timer_t startTime;
+	};
+
+	/**
+	 * Frame index, sorted by start time. It is filled in by the header scan
+	 * done in the constructor to compute the stream length, and then lets
+	 * seek() jump directly to the target frame instead of rescanning all
+	 * headers from the start of the stream.
+	 */
+	Common::Array<FrameIndexEntry> _frameIndex;
+	bool _buildIndex;
+
+	// Offset in the input stream of the first byte in _buf
+	uint32 _bufStartPos;
+
 	mad_stream _stream;
 	mad_frame _frame;
 	mad_synth _synth;
@@ -89,9 +111,11 @@ protected:
 	void decodeMP3Data();
 	void readMP3Data();
 
-	void initStream();
+	void initStream(uint32 offset = 0, mad_timer_t startTime = mad_timer_zero);
 	void readHeader();
 	void deinitStream();
+
+	bool seekIndexed(const mad_timer_t &destination);
 };
 
 MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag dispose) :
@@ -99,7 +123,9 @@ MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag
 	_posInFrame(0),
 	_state(MP3_STATE_INIT),
 	_length(0, 1000),
-	_totalTime(mad_timer_zero) {
+	_totalTime(mad_timer_zero),
+	_buildIndex(true),
+	_bufStartPos(0) {
 
 	// The MAD_BUFFER_GUARD must always contain zeros (the reason
 	// for this is that the Layer III Huffman decoder of libMAD
@@ -112,6 +138,8 @@ MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag
 	while (_state != MP3_STATE_EOS)
 		readHeader();
 
+	_buildIndex = false;
+
 	// To rule out any invalid sample rate to be encountered here, say in case the
 	// MP3 stream is invalid, we just check the MAD error code here.
 	// We need to assure this, since else we might trigger an assertion in Timestamp
@@ -195,6 +223,8 @@ void MP3Stream::readMP3Data() {
 		memmove(_buf, _stream.next_frame, remaining);
 	}
 
+	_bufStartPos = _inStream->pos() - remaining;
+
 	// Try to read the next block
 	uint32 size = _inStream->read(_buf + remaining, BUFFER_SIZE - remaining);
 	if (size <= 0) {
@@ -220,6 +250,9 @@ bool MP3Stream::seek(const Timestamp &where) {
 	mad_timer_t destination;
 	mad_timer_set(&destination, time / 1000, time % 1000, 1000);
 
+	if (!_frameIndex.empty())
+		return seekIndexed(destination);
+
 	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _totalTime) < 0)
 		initStream();
 
@@ -231,7 +264,31 @@ bool MP3Stream::seek(const Timestamp &where) {
 	return (_state != MP3_STATE_EOS);
 }
 
-void MP3Stream::initStream() {
+bool MP3Stream::seekIndexed(const mad_timer_t &destination) {
+	// Binary search for the first frame starting at or after the destination.
+	// This matches the frame the linear header scan above would stop at.
+	uint lo = 0, hi = _frameIndex.size();
+	while (lo < hi) {
+		const uint mid = lo + (hi - lo) / 2;
+		if (mad_timer_compare(_frameIndex[mid].startTime, destination) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == _frameIndex.size()) {
+		_state = MP3_STATE_EOS;
+		return false;
+	}
+
+	initStream(_frameIndex[lo].offset, _frameIndex[lo].startTime);
+
+	decodeMP3Data();
+
+	return (_state != MP3_STATE_EOS);
+}
+
+void MP3Stream::initStream(uint32 offset, mad_timer_t startTime) {
 	if (_state != MP3_STATE_INIT)
 		deinitStream();
 
@@ -241,8 +298,8 @@ void MP3Stream::initStream() {
 	mad_synth_init(&_synth);
 
 	// Reset the stream data
-	_inStream->seek(0, SEEK_SET);
-	_totalTime = mad_timer_zero;
+	_inStream->seek(offset, SEEK_SET);
+	_totalTime = startTime;
 	_posInFrame = 0;
 
 	// Update state
@@ -279,6 +336,13 @@ void MP3Stream::readHeader() {
 			}
 		}
 
+		if (_buildIndex) {
+			FrameIndexEntry entry;
+			entry.offset = _bufStartPos + (_stream.this_frame - _buf);
+			entry.startTime = _totalTime;
+			_frameIndex.push_back(entry);
+		}
+
 		// Sum up the total playback time so far
 		mad_timer_add(&_totalTime, _frame.header.duration);
 		break;
@@ -0,0 +1,447 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/decoders/pcmcache.h"
+
+#include "common/debug.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PCMCache);
+}
+
+namespace Audio {
+
+enum {
+	/** Default cache budget in bytes of decoded samples */
+	kDefaultMaxSize = 8 * 1024 * 1024,
+	/**
+	 * Number of samples decoded per prefetch timer tick. All timer procs
+	 * share one thread, so this is kept small enough not to delay MIDI
+	 * playback, while still decoding several times faster than realtime.
+	 */
+	kPrefetchChunkSamples = 4096,
+	/** Interval of the prefetch timer in microseconds */
+	kPrefetchInterval = 20000,
+	/** Maximum number of sounds waiting to be prefetched */
+	kMaxPrefetchJobs = 4
+};
+
+/**
+ * Decoded samples of one sound. Shared between the cache and all streams
+ * playing it, so evicting a sound does not affect playback in progress.
+ */
+struct PCMCache::Buffer {
+	int16 *samples;
+	uint32 numSamples;
+	uint32 capacity;
+	int rate;
+	bool stereo;
+
+	Buffer(uint32 cap, int r, bool s) : numSamples(0), capacity(cap), rate(r), stereo(s) {
+		samples = (int16 *)malloc(capacity * sizeof(int16));
+	}
+
+	~Buffer() {
+		free(samples);
+	}
+
+	uint32 byteSize() const { return numSamples * sizeof(int16); }
+
+	bool append(const int16 *data, uint32 count) {
+		if (numSamples + count > capacity) {
+			// The length reported by the decoder is only an estimate for
+			// some formats, so allow for a little overshoot.
+			uint32 newCapacity = MAX<uint32>(numSamples + count, capacity + capacity / 8);
+			int16 *newSamples = (int16 *)realloc(samples, newCapacity * sizeof(int16));
+			if (!newSamples)
+				return false;
+			samples = newSamples;
+			capacity = newCapacity;
+		}
+
+		memcpy(samples + numSamples, data, count * sizeof(int16));
+		numSamples += count;
+		return true;
+	}
+};
+
+/**
+ * Read stream over a cached buffer, which keeps the buffer alive for as
+ * long as the stream exists.
+ */
+class PCMCacheReadStream : public Common::MemoryReadStream {
+public:
+	PCMCacheReadStream(const PCMCache::BufferPtr &buffer)
+		: Common::MemoryReadStream((const byte *)buffer->samples, buffer->byteSize(), DisposeAfterUse::NO), _buffer(buffer) {}
+
+private:
+	PCMCache::BufferPtr _buffer;
+};
+
+/**
+ * Wrapper around a decoder for a sound which is not cached yet. The decoded
+ * samples are recorded while the sound plays, and handed over to the cache
+ * once the end of the sound is reached.
+ */
+class PCMRecordingStream : public SeekableAudioStream {
+public:
+	PCMRecordingStream(PCMCache &cache, const Common::String &key, SeekableAudioStream *decoder, const PCMCache::BufferPtr &buffer)
+		: _cache(cache), _key(key), _decoder(decoder), _buffer(buffer) {}
+
+	~PCMRecordingStream() {
+		delete _decoder;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = _decoder->readBuffer(buffer, numSamples);
+
+		if (_buffer) {
+			if (samples > 0 && !_buffer->append(buffer, samples)) {
+				_buffer.reset();
+			} else if (_decoder->endOfData()) {
+				_cache.insert(_key, _buffer);
+				_buffer.reset();
+			}
+		}
+
+		return samples;
+	}
+
+	bool isStereo() const { return _decoder->isStereo(); }
+	int getRate() const { return _decoder->getRate(); }
+	bool endOfData() const { return _decoder->endOfData(); }
+	bool endOfStream() const { return _decoder->endOfStream(); }
+
+	bool seek(const Timestamp &where) {
+		// Only an uninterrupted decode from the start yields a complete
+		// sound, so stop recording on any other seek.
+		if (_buffer) {
+			if (where.totalNumberOfFrames() == 0)
+				_buffer->numSamples = 0;
+			else
+				_buffer.reset();
+		}
+
+		return _decoder->seek(where);
+	}
+
+	Timestamp getLength() const { return _decoder->getLength(); }
+
+private:
+	PCMCache &_cache;
+	const Common::String _key;
+	SeekableAudioStream *_decoder;
+	PCMCache::BufferPtr _buffer;
+};
+
+PCMCache::PCMCache() : _timerInstalled(false), _maxSize(kDefaultMaxSize), _size(0),
+	_hits(0), _misses(0), _prefetched(0), _evictions(0) {
+}
+
+PCMCache::~PCMCache() {
+	clear();
+}
+
+Common::String PCMCache::makeKey(const Common::String &archive, uint32 offset, uint32 size) {
+	return Common::String::format("%s:%u:%u", archive.c_str(), offset, size);
+}
+
+PCMCache::BufferPtr PCMCache::allocateBuffer(SeekableAudioStream *decoder, uint32 maxSize) {
+	const int rate = decoder->getRate();
+	if (rate <= 0)
+		return BufferPtr();
+
+	const int channels = decoder->isStereo() ? 2 : 1;
+	const uint64 numSamples = (uint64)decoder->getLength().convertToFramerate(rate).totalNumberOfFrames() * channels;
+	if (numSamples == 0 || numSamples * sizeof(int16) > maxSize)
+		return BufferPtr();
+
+	BufferPtr buffer(new Buffer((uint32)numSamples, rate, channels == 2));
+	if (!buffer->samples)
+		return BufferPtr();
+
+	return buffer;
+}
+
+SeekableAudioStream *PCMCache::makeRawStream(const BufferPtr &buffer) {
+	byte flags = FLAG_16BITS;
+#ifdef SCUMM_LITTLE_ENDIAN
+	flags |= FLAG_LITTLE_ENDIAN;
+#endif
+	if (buffer->stereo)
+		flags |= FLAG_STEREO;
+
+	return Audio::makeRawStream(new PCMCacheReadStream(buffer), buffer->rate, flags, DisposeAfterUse::YES);
+}
+
+SeekableAudioStream *PCMCache::makeStream(const Common::String &archive, uint32 offset, uint32 size,
+                                          SeekableAudioStream *decoder) {
+	if (!decoder)
+		return 0;
+
+	SeekableAudioStream *cached = getStream(archive, offset, size);
+	if (cached) {
+		delete decoder;
+		return cached;
+	}
+
+	BufferPtr buffer;
+	{
+		Common::StackLock lock(_mutex);
+		++_misses;
+		buffer = allocateBuffer(decoder, _maxSize);
+	}
+
+	if (!buffer)
+		return decoder;
+
+	return new PCMRecordingStream(*this, makeKey(archive, offset, size), decoder, buffer);
+}
+
+SeekableAudioStream *PCMCache::getStream(const Common::String &archive, uint32 offset, uint32 size) {
+	BufferPtr buffer;
+	{
+		Common::StackLock lock(_mutex);
+
+		EntryMap::iterator i = _map.find(makeKey(archive, offset, size));
+		if (i == _map.end())
+			return 0;
+
+		// Move the entry to the front of the LRU list
+		Entry entry = *i->_value;
+		_entries.erase(i->_value);
+		_entries.push_front(entry);
+		i->_value = _entries.begin();
+
+		buffer = entry.buffer;
+		++_hits;
+	}
+
+	return makeRawStream(buffer);
+}
+
+void PCMCache::prefetch(const Common::String &archive, uint32 offset, uint32 size,
+                        Common::SeekableReadStream *stream, DecoderFactory factory) {
+	if (!stream)
+		return;
+
+	const Common::String key = makeKey(archive, offset, size);
+
+	bool installTimer;
+	{
+		Common::StackLock lock(_mutex);
+
+		if (!factory || !canPrefetch(key)) {
+			delete stream;
+			return;
+		}
+
+		PrefetchJob job;
+		job.key = key;
+		job.stream = stream;
+		job.factory = factory;
+		job.decoder = 0;
+		_prefetchQueue.push_back(job);
+
+		installTimer = !_timerInstalled;
+		_timerInstalled = true;
+	}
+
+	// The timer is installed outside of our lock, since the timer manager
+	// holds its own lock while calling timerProc, which takes ours. If
+	// timerProc is just removing itself, installing waits for that.
+	if (installTimer && !g_system->getTimerManager()->installTimerProc(&timerProc, kPrefetchInterval, this, "PCMCache")) {
+		Common::StackLock lock(_mutex);
+		_timerInstalled = false;
+	}
+}
+
+bool PCMCache::needsPrefetch(const Common::String &archive, uint32 offset, uint32 size) const {
+	Common::StackLock lock(_mutex);
+	return canPrefetch(makeKey(archive, offset, size));
+}
+
+bool PCMCache::canPrefetch(const Common::String &key) const {
+	if (_map.contains(key) || _prefetchQueue.size() >= kMaxPrefetchJobs)
+		return false;
+
+	for (Common::List<PrefetchJob>::const_iterator i = _prefetchQueue.begin(); i != _prefetchQueue.end(); ++i) {
+		if (i->key == key)
+			return false;
+	}
+
+	return true;
+}
+
+void PCMCache::setMaxSize(uint32 bytes) {
+	Common::StackLock lock(_mutex);
+	_maxSize = bytes;
+	evict(0);
+}
+
+void PCMCache::clear() {
+	// Removing the timer waits for a running timerProc to finish, so it
+	// has to happen before taking our lock. Afterwards no prefetch job is
+	// being decoded anymore. The timer proc may be removing itself right
+	// now, so remove it regardless of _timerInstalled.
+	if (g_system->getTimerManager())
+		g_system->getTimerManager()->removeTimerProc(&timerProc);
+
+	Common::StackLock lock(_mutex);
+
+	_timerInstalled = false;
+	_entries.clear();
+	_map.clear();
+	_size = 0;
+
+	for (Common::List<PrefetchJob>::iterator i = _prefetchQueue.begin(); i != _prefetchQueue.end(); ++i) {
+		delete i->decoder;
+		delete i->stream;
+	}
+	_prefetchQueue.clear();
+}
+
+PCMCache::Stats PCMCache::getStats() const {
+	Common::StackLock lock(_mutex);
+
+	Stats stats;
+	stats.hits = _hits;
+	stats.misses = _misses;
+	stats.prefetched = _prefetched;
+	stats.evictions = _evictions;
+	stats.entries = _map.size();
+	stats.bytesCached = _size;
+	return stats;
+}
+
+void PCMCache::insert(const Common::String &key, const BufferPtr &buffer) {
+	Common::StackLock lock(_mutex);
+	addEntry(key, buffer);
+}
+
+bool PCMCache::addEntry(const Common::String &key, const BufferPtr &buffer) {
+	const uint32 bytes = buffer->byteSize();
+	if (_map.contains(key) || bytes == 0 || bytes > _maxSize)
+		return false;
+
+	evict(bytes);
+
+	Entry entry;
+	entry.key = key;
+	entry.buffer = buffer;
+	_entries.push_front(entry);
+	_map[key] = _entries.begin();
+	_size += bytes;
+
+	debug(9, "PCMCache: Cached %s (%u bytes, %u total)", key.c_str(), bytes, _size);
+	return true;
+}
+
+void PCMCache::evict(uint32 bytesNeeded) {
+	while (!_entries.empty() && _size + bytesNeeded > _maxSize) {
+		const Entry &entry = _entries.back();
+		_size -= entry.buffer->byteSize();
+		_map.erase(entry.key);
+		_entries.pop_back();
+		++_evictions;
+	}
+}
+
+void PCMCache::timerProc(void *refCon) {
+	((PCMCache *)refCon)->processPrefetch();
+}
+
+void PCMCache::processPrefetch() {
+	PrefetchJob *job = 0;
+	{
+		Common::StackLock lock(_mutex);
+
+		if (_prefetchQueue.empty())
+			_timerInstalled = false;
+		else
+			job = &_prefetchQueue.front();
+	}
+
+	if (!job) {
+		// Nothing left to decode, so stop calling us until the next
+		// prefetch(). See prefetch() for why this happens unlocked.
+		g_system->getTimerManager()->removeTimerProc(&timerProc);
+		return;
+	}
+
+	// Work without holding the lock, so that the mixer is not kept
+	// waiting. Only this timer and clear(), which removes the timer first,
+	// remove jobs from the queue, so the front job stays valid meanwhile.
+	if (!job->decoder) {
+		// Creating the decoder may read through the whole sound, e.g. to
+		// index MP3 frames, so that is all the work done in this tick.
+		job->decoder = job->factory(job->stream, DisposeAfterUse::YES);
+		job->stream = 0;
+
+		BufferPtr buffer;
+		if (job->decoder) {
+			Common::StackLock lock(_mutex);
+			buffer = allocateBuffer(job->decoder, _maxSize);
+		}
+
+		if (buffer)
+			job->buffer = buffer;
+		else
+			finishPrefetch(BufferPtr());
+		return;
+	}
+
+	BufferPtr buffer = job->buffer;
+
+	int16 samples[kPrefetchChunkSamples];
+	const int count = job->decoder->readBuffer(samples, kPrefetchChunkSamples);
+
+	bool done = job->decoder->endOfData();
+	if (count > 0 && !buffer->append(samples, count)) {
+		buffer.reset();
+		done = true;
+	}
+
+	if (done)
+		finishPrefetch(buffer);
+}
+
+void PCMCache::finishPrefetch(const BufferPtr &buffer) {
+	Common::StackLock lock(_mutex);
+
+	PrefetchJob &job = _prefetchQueue.front();
+	if (buffer && addEntry(job.key, buffer))
+		++_prefetched;
+
+	delete job.decoder;
+	delete job.stream;
+	_prefetchQueue.pop_front();
+}
+
+} // End of namespace Audio
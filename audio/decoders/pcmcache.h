@@ -0,0 +1,192 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * Decoded PCM cache used in engines:
+ *  - scumm
+ */
+
+#ifndef AUDIO_PCMCACHE_H
+#define AUDIO_PCMCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/str.h"
+#include "common/types.h"
+
+namespace Common {
+class SeekableReadStream;
+}
+
+namespace Audio {
+
+class SeekableAudioStream;
+
+/**
+ * Size bounded cache of fully decoded compressed sounds (MP3, Vorbis, FLAC).
+ *
+ * Sounds are identified by the archive they are stored in together with
+ * their offset and size inside it. A sound that is not cached yet is played
+ * from its decoder as usual, and the decoded samples are recorded on the way
+ * so that the next playback is served by a RawStream over the cached buffer.
+ * Sounds which are likely to be played soon can also be decoded in advance
+ * from a timer callback via prefetch().
+ */
+class PCMCache : public Common::Singleton<PCMCache> {
+public:
+	/**
+	 * Function creating a decoder for compressed sound data, like
+	 * makeMP3Stream(), makeVorbisStream() or makeFLACStream().
+	 */
+	typedef SeekableAudioStream *(*DecoderFactory)(Common::SeekableReadStream *stream, DisposeAfterUse::Flag disposeAfterUse);
+
+	struct Stats {
+		uint32 hits;
+		uint32 misses;
+		uint32 prefetched;
+		uint32 evictions;
+		uint32 entries;
+		uint32 bytesCached;
+	};
+
+	/**
+	 * Create a stream for the given sound.
+	 *
+	 * If the sound is cached, the decoder is deleted and a RawStream over the
+	 * cached samples is returned instead. Otherwise a wrapper around the
+	 * decoder is returned, which adds the decoded samples to the cache once
+	 * the sound has been played to the end.
+	 *
+	 * @param archive	name of the file the sound is stored in
+	 * @param offset	offset of the sound inside the archive
+	 * @param size		size of the compressed sound data
+	 * @param decoder	decoder for the sound, ownership is transferred
+	 * @return a new SeekableAudioStream, or 0 if decoder was 0
+	 */
+	SeekableAudioStream *makeStream(const Common::String &archive, uint32 offset, uint32 size,
+	                                SeekableAudioStream *decoder);
+
+	/**
+	 * Return a stream for a cached sound.
+	 *
+	 * @return a RawStream over the cached samples, or 0 if the sound is not cached
+	 */
+	SeekableAudioStream *getStream(const Common::String &archive, uint32 offset, uint32 size);
+
+	/**
+	 * Queue a sound to be decoded in the background. Nothing happens if the
+	 * sound is already cached or queued.
+	 *
+	 * The decoder is created by the prefetch timer as well, since creating
+	 * it may already require reading through the whole sound.
+	 *
+	 * @param stream	compressed sound data, ownership is transferred
+	 * @param factory	function creating the decoder for stream
+	 */
+	void prefetch(const Common::String &archive, uint32 offset, uint32 size,
+	              Common::SeekableReadStream *stream, DecoderFactory factory);
+
+	/**
+	 * Check whether prefetch() would queue the given sound, i.e. whether it
+	 * is neither cached nor queued already and the queue is not full. This
+	 * allows skipping the creation of a decoder which would not be used.
+	 */
+	bool needsPrefetch(const Common::String &archive, uint32 offset, uint32 size) const;
+
+	/** Set the maximum number of bytes of decoded samples kept in the cache. */
+	void setMaxSize(uint32 bytes);
+	uint32 getMaxSize() const { return _maxSize; }
+
+	/** Drop all cached sounds and pending prefetch requests, and stop the prefetch timer. */
+	void clear();
+
+	Stats getStats() const;
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	friend class PCMCacheReadStream;
+	friend class PCMRecordingStream;
+
+	PCMCache();
+	~PCMCache();
+
+	struct Buffer;
+	typedef Common::SharedPtr<Buffer> BufferPtr;
+
+	struct Entry {
+		Common::String key;
+		BufferPtr buffer;
+	};
+
+	typedef Common::List<Entry> EntryList;
+	typedef Common::HashMap<Common::String, EntryList::iterator> EntryMap;
+
+	struct PrefetchJob {
+		Common::String key;
+		Common::SeekableReadStream *stream;
+		DecoderFactory factory;
+		SeekableAudioStream *decoder;	///< Created by the first timer tick
+		BufferPtr buffer;
+	};
+
+	static Common::String makeKey(const Common::String &archive, uint32 offset, uint32 size);
+	static BufferPtr allocateBuffer(SeekableAudioStream *decoder, uint32 maxSize);
+	static SeekableAudioStream *makeRawStream(const BufferPtr &buffer);
+
+	bool canPrefetch(const Common::String &key) const;
+	void insert(const Common::String &key, const BufferPtr &buffer);
+	bool addEntry(const Common::String &key, const BufferPtr &buffer);
+	void evict(uint32 bytesNeeded);
+
+	static void timerProc(void *refCon);
+	void processPrefetch();
+	void finishPrefetch(const BufferPtr &buffer);
+
+	mutable Common::Mutex _mutex;
+
+	/** Cached sounds, most recently used first. */
+	EntryList _entries;
+	EntryMap _map;
+
+	Common::List<PrefetchJob> _prefetchQueue;
+	bool _timerInstalled;	///< Protected by _mutex
+
+	uint32 _maxSize;
+	uint32 _size;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _prefetched;
+	uint32 _evictions;
+};
+
+} // End of namespace Audio
+
+/** Shortcut for accessing the decoded PCM cache. */
+#define PCMCacheMan Audio::PCMCache::instance()
+
+#endif
@@ -21,6 +21,7 @@ MODULE_OBJS := \
 	decoders/iff_sound.o \
 	decoders/mac_snd.o \
 	decoders/mp3.o \
+	decoders/pcmcache.o \
 	decoders/qdm2.o \
 	decoders/quicktime.o \
 	decoders/raw.o \
@@ -38,6 +39,7 @@ MODULE_OBJS := \
 	mods/tfmx.o \
 	softsynth/adlib.o \
 	softsynth/cms.o \
+	softsynth/emumidi.o \
 	softsynth/opl/dbopl.o \
 	softsynth/opl/dosbox.o \
 	softsynth/opl/mame.o \
@@ -0,0 +1,215 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/softsynth/emumidi.h"
+
+#include "common/system.h"
+#include "common/timer.h"
+#include "common/util.h"
+
+enum {
+	/** Interval of the render-ahead timer in microseconds */
+	kRenderAheadInterval = 10000,
+	/** Maximum number of frames generated in one go by the render-ahead timer */
+	kRenderAheadChunk = 512
+};
+
+MidiDriver_Emulated *MidiDriver_Emulated::_renderAheadDrivers = 0;
+
+void MidiDriver_Emulated::render(int16 *data, int numSamples) {
+	const int stereoFactor = isStereo() ? 2 : 1;
+	int len = numSamples / stereoFactor;
+	int step;
+
+	do {
+		step = len;
+		if (step > (_nextTick >> FIXP_SHIFT))
+			step = (_nextTick >> FIXP_SHIFT);
+
+		generateSamples(data, step);
+
+		_nextTick -= step << FIXP_SHIFT;
+		if (!(_nextTick >> FIXP_SHIFT)) {
+			if (_timerProc)
+				(*_timerProc)(_timerParam);
+
+			onTimer();
+
+			_nextTick += _samplesPerTick;
+		}
+
+		data += step * stereoFactor;
+		len -= step;
+	} while (len);
+}
+
+int MidiDriver_Emulated::copyAhead(int16 *data, int numSamples) {
+	uint32 read, available;
+	{
+		Common::StackLock lock(_aheadMutex);
+		read = _aheadRead;
+		available = _aheadWrite - _aheadRead;
+	}
+
+	const int total = MIN<uint32>(available, numSamples);
+	int done = 0;
+	while (done < total) {
+		const uint32 pos = read & _aheadMask;
+		const int chunk = MIN<uint32>(total - done, _aheadMask + 1 - pos);
+		memcpy(data + done, _aheadBuffer + pos, chunk * sizeof(int16));
+		done += chunk;
+		read += chunk;
+	}
+
+	Common::StackLock lock(_aheadMutex);
+	_aheadRead = read;
+	return done;
+}
+
+int MidiDriver_Emulated::readBuffer(int16 *data, const int numSamples) {
+	if (!_aheadBuffer) {
+		render(data, numSamples);
+		return numSamples;
+	}
+
+	int done = copyAhead(data, numSamples);
+	if (done < numSamples) {
+		// The render-ahead timer did not keep up. Take over the synth, and
+		// check the queue once more, since the timer might have added to it
+		// while we waited, before rendering the rest inline.
+		Common::StackLock renderLock(_renderMutex);
+		done += copyAhead(data + done, numSamples - done);
+		if (done < numSamples) {
+			++_aheadUnderruns;
+			render(data + done, numSamples - done);
+		}
+	}
+
+	return numSamples;
+}
+
+void MidiDriver_Emulated::renderAhead() {
+	Common::StackLock renderLock(_renderMutex);
+
+	if (!_aheadBuffer)
+		return;
+
+	const int stereoFactor = isStereo() ? 2 : 1;
+
+	for (;;) {
+		uint32 write, available;
+		{
+			Common::StackLock lock(_aheadMutex);
+			write = _aheadWrite;
+			available = _aheadWrite - _aheadRead;
+		}
+
+		if (available >= _aheadTarget)
+			break;
+
+		const uint32 pos = write & _aheadMask;
+		uint32 count = MIN<uint32>(_aheadTarget - available, _aheadMask + 1 - pos);
+		count = MIN<uint32>(count, kRenderAheadChunk * stereoFactor);
+		count -= count % stereoFactor;
+		if (!count)
+			break;
+
+		render(_aheadBuffer + pos, count);
+
+		Common::StackLock lock(_aheadMutex);
+		_aheadWrite = write + count;
+	}
+}
+
+void MidiDriver_Emulated::renderAheadProc(void *refCon) {
+	for (MidiDriver_Emulated *driver = _renderAheadDrivers; driver; driver = driver->_nextRenderAhead)
+		driver->renderAhead();
+}
+
+void MidiDriver_Emulated::setRenderAheadActive(bool active) {
+	Common::TimerManager *timer = g_system->getTimerManager();
+
+	// Removing the timer proc waits for a running call to finish, so
+	// afterwards the list can be changed safely.
+	if (_renderAheadDrivers)
+		timer->removeTimerProc(&renderAheadProc);
+
+	if (active) {
+		_nextRenderAhead = _renderAheadDrivers;
+		_renderAheadDrivers = this;
+	} else {
+		MidiDriver_Emulated **link = &_renderAheadDrivers;
+		while (*link && *link != this)
+			link = &(*link)->_nextRenderAhead;
+		if (*link)
+			*link = _nextRenderAhead;
+		_nextRenderAhead = 0;
+	}
+
+	if (_renderAheadDrivers)
+		timer->installTimerProc(&renderAheadProc, kRenderAheadInterval, 0, "MidiDriver_Emulated");
+}
+
+void MidiDriver_Emulated::setRenderAhead(uint32 latency) {
+	if (_aheadBuffer) {
+		setRenderAheadActive(false);
+
+		Common::StackLock renderLock(_renderMutex);
+		delete[] _aheadBuffer;
+		_aheadBuffer = 0;
+	}
+
+	if (!latency || !_isOpen)
+		return;
+
+	const int stereoFactor = isStereo() ? 2 : 1;
+	_aheadTarget = (uint32)getRate() * latency / 1000 * stereoFactor;
+
+	// The ring buffer has to hold the target amount plus whatever the
+	// timer renders beyond it in one chunk.
+	uint32 size = 1;
+	while (size < _aheadTarget + kRenderAheadChunk * stereoFactor)
+		size <<= 1;
+
+	{
+		Common::StackLock renderLock(_renderMutex);
+		_aheadBuffer = new int16[size];
+		_aheadMask = size - 1;
+		_aheadRead = _aheadWrite = 0;
+		_aheadUnderruns = 0;
+	}
+
+	setRenderAheadActive(true);
+}
+
+uint32 MidiDriver_Emulated::getRenderAheadLatency() {
+	if (!_aheadBuffer)
+		return 0;
+
+	uint32 available;
+	{
+		Common::StackLock lock(_aheadMutex);
+		available = _aheadWrite - _aheadRead;
+	}
+
+	return available * 1000 / (getRate() * (isStereo() ? 2 : 1));
+}
@@ -26,6 +26,8 @@
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
 
+#include "common/mutex.h"
+
 class MidiDriver_Emulated : public Audio::AudioStream, public MidiDriver {
 protected:
 	bool _isOpen;
@@ -43,6 +45,38 @@ private:
 	int _nextTick;
 	int _samplesPerTick;
 
+	/**
+	 * Render-ahead state. When enabled, the synth is run from a timer
+	 * callback instead of the mixer callback, and the output is queued in
+	 * the ring buffer _aheadBuffer, from which readBuffer() then copies.
+	 * _aheadRead and _aheadWrite count samples and only ever increase, the
+	 * ring buffer position is obtained by masking with _aheadMask.
+	 */
+	int16 *_aheadBuffer;
+	uint32 _aheadMask;
+	uint32 _aheadRead;
+	uint32 _aheadWrite;
+	uint32 _aheadTarget;
+	uint32 _aheadUnderruns;
+	/** Protects _aheadRead and _aheadWrite */
+	Common::Mutex _aheadMutex;
+	/** Serializes all calls into the synth made by render() */
+	Common::Mutex _renderMutex;
+
+	/**
+	 * All drivers rendering ahead are served by one timer proc, since the
+	 * timer manager can only remove timer procs by their function. The list
+	 * is only changed while that timer proc is removed.
+	 */
+	static MidiDriver_Emulated *_renderAheadDrivers;
+	MidiDriver_Emulated *_nextRenderAhead;
+
+	void render(int16 *data, int numSamples);
+	int copyAhead(int16 *data, int numSamples);
+	void renderAhead();
+	void setRenderAheadActive(bool active);
+	static void renderAheadProc(void *refCon);
+
 protected:
 	int _baseFreq;
 
@@ -57,9 +91,22 @@ public:
 		_timerParam(0),
 		_nextTick(0),
 		_samplesPerTick(0),
+		_aheadBuffer(0),
+		_aheadMask(0),
+		_aheadRead(0),
+		_aheadWrite(0),
+		_aheadTarget(0),
+		_aheadUnderruns(0),
+		_nextRenderAhead(0),
 		_baseFreq(250) {
 	}
 
+	virtual ~MidiDriver_Emulated() {
+		// Render-ahead calls into the synth of the derived class, which is
+		// already destroyed at this point.
+		assert(!_aheadBuffer);
+	}
+
 	// MidiDriver API
 	virtual int open() {
 		_isOpen = true;
@@ -86,35 +133,33 @@ public:
 		return 1000000 / _baseFreq;
 	}
 
-	// AudioStream API
-	virtual int readBuffer(int16 *data, const int numSamples) {
-		const int stereoFactor = isStereo() ? 2 : 1;
-		int len = numSamples / stereoFactor;
-		int step;
-
-		do {
-			step = len;
-			if (step > (_nextTick >> FIXP_SHIFT))
-				step = (_nextTick >> FIXP_SHIFT);
-
-			generateSamples(data, step);
+	/**
+	 * Enable or disable rendering ahead of the mixer.
+	 *
+	 * When enabled, the timer callback and generateSamples() are driven
+	 * from a timer thread, which keeps about the given amount of audio
+	 * queued in front of the mixer. The timer callback therefore sees the
+	 * time of the rendered audio, not of the audio currently playing, and
+	 * MIDI events it sends are placed sample accurately in the output,
+	 * delayed by the queued amount. This is the render latency.
+	 *
+	 * Drivers must only enable this once the synth is fully set up, and
+	 * must disable it in close() and in their destructor before tearing the
+	 * synth down.
+	 *
+	 * @param latency	amount of audio to render ahead in milliseconds,
+	 *					0 to render inline in the mixer callback
+	 */
+	void setRenderAhead(uint32 latency);
+
+	/** Return the amount of audio currently rendered ahead in milliseconds. */
+	uint32 getRenderAheadLatency();
+
+	/** Return how often the mixer had to render inline since render-ahead was enabled. */
+	uint32 getRenderAheadUnderruns() const { return _aheadUnderruns; }
 
-			_nextTick -= step << FIXP_SHIFT;
-			if (!(_nextTick >> FIXP_SHIFT)) {
-				if (_timerProc)
-					(*_timerProc)(_timerParam);
-
-				onTimer();
-
-				_nextTick += _samplesPerTick;
-			}
-
-			data += step * stereoFactor;
-			len -= step;
-		} while (len);
-
-		return numSamples;
-	}
+	// AudioStream API
+	virtual int readBuffer(int16 *data, const int numSamples);
 
 	virtual bool endOfData() const {
 		return false;
@@ -161,6 +161,7 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
+	setRenderAhead(0);
 	deleteMuntStructures();
 }
 
@@ -229,6 +230,11 @@ int MidiDriver_MT32::open() {
 
 	g_system->updateScreen();
 
+	// Emulating the MT-32 is expensive, so optionally do it on the timer
+	// thread instead of in the mixer callback.
+	if (ConfMan.hasKey("mt32_render_ahead"))
+		setRenderAhead(ConfMan.getInt("mt32_render_ahead"));
+
 	_mixer->playStream(Audio::Mixer::kSFXSoundType, &_mixerSoundHandle, this, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO, true);
 
 	return 0;
@@ -272,6 +278,7 @@ void MidiDriver_MT32::close() {
 	setTimerCallback(NULL, NULL);
 	// Detach the mixer callback handler
 	_mixer->stopHandle(_mixerSoundHandle);
+	setRenderAhead(0);
 
 	_synth->close();
 	deleteMuntStructures();
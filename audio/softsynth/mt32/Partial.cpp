@@ -298,13 +298,18 @@ bool Partial::produceOutput(float *leftBuf, float *rightBuf, unsigned long lengt
 		return false;
 	}
 	unsigned long numGenerated = generateSamples(myBuffer, length);
-	for (unsigned int i = 0; i < numGenerated; i++) {
-		*leftBuf++ = myBuffer[i] * stereoVolume.leftVol;
-		*rightBuf++ = myBuffer[i] * stereoVolume.rightVol;
-	}
-	for (; numGenerated < length; numGenerated++) {
-		*leftBuf++ = 0.0f;
-		*rightBuf++ = 0.0f;
+	// Mix straight into the output buffers. This is a plain loop over
+	// independent samples, which the compiler can vectorize, and saves
+	// the round trip through a per-partial float buffer.
+	// Note that compilers may fuse the multiply and add here (e.g. GCC with
+	// -ffp-contract=fast on targets with FMA instructions), which rounds
+	// only once. The output can then differ from the old separate mixing
+	// pass in the lowest bits.
+	const float leftVol = stereoVolume.leftVol;
+	const float rightVol = stereoVolume.rightVol;
+	for (unsigned long i = 0; i < numGenerated; i++) {
+		leftBuf[i] += myBuffer[i] * leftVol;
+		rightBuf[i] += myBuffer[i] * rightVol;
 	}
 	return true;
 }
@@ -98,9 +98,10 @@ public:
 	const ControlROMPCMStruct *getControlROMPCMStruct() const;
 	Synth *getSynth() const;
 
-	// Returns true only if data written to buffer
-	// This function (unlike the one below it) returns processed stereo samples
-	// made from combining this single partial with its pair, if it has one.
+	// Returns true only if data was mixed into the buffers
+	// This function (unlike the one below it) adds processed stereo samples
+	// made from combining this single partial with its pair, if it has one,
+	// to the existing contents of the buffers.
 	bool produceOutput(float *leftBuf, float *rightBuf, unsigned long length);
 
 	// This function writes mono sample output to the provided buffer, and returns the number of samples written
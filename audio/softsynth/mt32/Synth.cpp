@@ -60,14 +60,6 @@ static inline void clearIfNonNull(Bit16s *stream, Bit32u len) {
 	}
 }
 
-static inline void mix(float *target, const float *stream, Bit32u len) {
-	while (len--) {
-		*target += *stream;
-		stream++;
-		target++;
-	}
-}
-
 static inline void clearFloats(float *leftBuf, float *rightBuf, Bit32u len) {
 	// FIXME: Use memset() where compatibility is guaranteed (if this turns out to be a win)
 	while (len--) {
@@ -1438,10 +1430,7 @@ void Synth::doRenderStreams(Bit16s *nonReverbLeft, Bit16s *nonReverbRight, Bit16
 	clearFloats(&tmpBufMixLeft[0], &tmpBufMixRight[0], len);
 	if (!reverbEnabled) {
 		for (unsigned int i = 0; i < MT32EMU_MAX_PARTIALS; i++) {
-			if (partialManager->produceOutput(i, &tmpBufPartialLeft[0], &tmpBufPartialRight[0], len)) {
-				mix(&tmpBufMixLeft[0], &tmpBufPartialLeft[0], len);
-				mix(&tmpBufMixRight[0], &tmpBufPartialRight[0], len);
-			}
+			partialManager->produceOutput(i, &tmpBufMixLeft[0], &tmpBufMixRight[0], len);
 		}
 		if (nonReverbLeft != NULL) {
 			la32FloatToBit16sFunc(nonReverbLeft, &tmpBufMixLeft[0], len, outputGain);
@@ -1456,10 +1445,7 @@ void Synth::doRenderStreams(Bit16s *nonReverbLeft, Bit16s *nonReverbRight, Bit16
 	} else {
 		for (unsigned int i = 0; i < MT32EMU_MAX_PARTIALS; i++) {
 			if (!partialManager->shouldReverb(i)) {
-				if (partialManager->produceOutput(i, &tmpBufPartialLeft[0], &tmpBufPartialRight[0], len)) {
-					mix(&tmpBufMixLeft[0], &tmpBufPartialLeft[0], len);
-					mix(&tmpBufMixRight[0], &tmpBufPartialRight[0], len);
-				}
+				partialManager->produceOutput(i, &tmpBufMixLeft[0], &tmpBufMixRight[0], len);
 			}
 		}
 		if (nonReverbLeft != NULL) {
@@ -1472,10 +1458,7 @@ void Synth::doRenderStreams(Bit16s *nonReverbLeft, Bit16s *nonReverbRight, Bit16
 		clearFloats(&tmpBufMixLeft[0], &tmpBufMixRight[0], len);
 		for (unsigned int i = 0; i < MT32EMU_MAX_PARTIALS; i++) {
 			if (partialManager->shouldReverb(i)) {
-				if (partialManager->produceOutput(i, &tmpBufPartialLeft[0], &tmpBufPartialRight[0], len)) {
-					mix(&tmpBufMixLeft[0], &tmpBufPartialLeft[0], len);
-					mix(&tmpBufMixRight[0], &tmpBufPartialRight[0], len);
-				}
+				partialManager->produceOutput(i, &tmpBufMixLeft[0], &tmpBufMixRight[0], len);
 			}
 		}
 		if (reverbDryLeft != NULL) {
@@ -172,6 +172,10 @@ static Bit16u MulTable[ 384 ];
 
 static Bit8u KslTable[ 8 * 16 ];
 static Bit8u TremoloTable[ TREMOLO_TABLE ];
+//Noise generator state after 32 steps, one table for each byte of the state
+static Bit32u Noise32Table[ 3 * 256 ];
+//Noise generator state after 8 steps, indexed by the low byte of the state
+static Bit32u Noise8Table[ 256 ];
 //Start of a channel behind the chip struct start
 static Bit16u ChanOffsetTable[32];
 //Start of an operator behind the chip struct start
@@ -1030,6 +1034,18 @@ INLINE Bit32u Chip::ForwardNoise() {
 	noiseCounter += noiseAdd;
 	Bitu count = noiseCounter >> LFO_SH;
 	noiseCounter &= WAVE_MASK;
+	//The generator is linear, so several steps can be done at once by
+	//combining the results for the separate bytes of the state.
+	//The state never exceeds 23 bits and bits above the low byte
+	//can't reach the feedback within 8 steps
+	for ( ; count >= 32; count -= 32 ) {
+		noiseValue = Noise32Table[ noiseValue & 0xff ]
+			^ Noise32Table[ 0x100 + ( ( noiseValue >> 8 ) & 0xff ) ]
+			^ Noise32Table[ 0x200 + ( noiseValue >> 16 ) ];
+	}
+	for ( ; count >= 8; count -= 8 ) {
+		noiseValue = ( noiseValue >> 8 ) ^ Noise8Table[ noiseValue & 0xff ];
+	}
 	for ( ; count > 0; --count ) {
 		//Noise calculation from mame
 		noiseValue ^= ( 0x800302 ) & ( 0 - (noiseValue & 1 ) );
@@ -1463,6 +1479,17 @@ void InitTables( void ) {
 		TremoloTable[i] = val;
 		TremoloTable[TREMOLO_TABLE - 1 - i] = val;
 	}
+	//Create the noise tables by running the generator on every byte value
+	for ( Bitu i = 0; i < 3 * 256; i++ ) {
+		Bit32u val = ( i & 0xff ) << ( ( i >> 8 ) * 8 );
+		for ( int step = 0; step < 32; step++ ) {
+			val ^= ( 0x800302 ) & ( 0 - (val & 1 ) );
+			val >>= 1;
+			if ( step == 7 && i < 256 )
+				Noise8Table[i] = val;
+		}
+		Noise32Table[i] = val;
+	}
 	//Create a table with offsets of the channels from the start of the chip
 	DBOPL::Chip* chip = 0;
 	for ( Bitu i = 0; i < 32; i++ ) {
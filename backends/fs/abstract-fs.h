@@ -158,6 +158,20 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified,
+	 * in seconds since an arbitrary, backend specific epoch.
+	 *
+	 * @return the modification time, or 0 if it is unknown
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
+	/**
+	 * Returns the size of the file referred by this path.
+	 *
+	 * @return the size in bytes, or -1 if it is unknown
+	 */
+	virtual int32 getFileSize() const { return -1; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -168,6 +182,15 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a MemoryReadStream instance over a read-only memory mapping of
+	 * the file referred by this node. Backends supporting memory mapping
+	 * override this, the default implementation returns 0.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::MemoryReadStream *createMappedReadStream() { return 0; }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
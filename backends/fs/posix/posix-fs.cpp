@@ -32,12 +32,21 @@
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/stdiostream.h"
 #include "common/algorithm.h"
+#include "common/memstream.h"
 
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <stdio.h>
 
+// Memory mapping is not available on all systems using the POSIX nodes
+#if !defined(PLAYSTATION3) && !defined(__OS2__)
+#define POSIX_FS_USE_MMAP
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #ifdef __OS2__
 #define INCL_DOS
 #include <os2.h>
@@ -47,11 +56,43 @@
 void POSIXFilesystemNode::setFlags() {
 	struct stat st;
 
-	_isValid = (0 == stat(_path.c_str(), &st));
+	_isValid = readStat(st);
 	_isDirectory = _isValid ? S_ISDIR(st.st_mode) : false;
 }
 
-POSIXFilesystemNode::POSIXFilesystemNode(const Common::String &p) {
+bool POSIXFilesystemNode::readStat(struct stat &st) const {
+	_hasStat = true;
+
+	if (stat(_path.c_str(), &st) != 0) {
+		_mtime = 0;
+		_fileSize = -1;
+		return false;
+	}
+
+	_mtime = (uint32)st.st_mtime;
+	_fileSize = S_ISREG(st.st_mode) ? (int32)st.st_size : -1;
+	return true;
+}
+
+uint32 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+
+	if (!_hasStat)
+		readStat(st);
+
+	return _mtime;
+}
+
+int32 POSIXFilesystemNode::getFileSize() const {
+	struct stat st;
+
+	if (!_hasStat)
+		readStat(st);
+
+	return _fileSize;
+}
+
+POSIXFilesystemNode::POSIXFilesystemNode(const Common::String &p) : _hasStat(false), _mtime(0), _fileSize(-1) {
 	assert(p.size() > 0);
 
 	// Expand "~/" to the value of the HOME env variable
@@ -168,6 +209,7 @@ bool POSIXFilesystemNode::getChildren(AbstractFSList &myList, ListMode mode, boo
 		if (_path.lastChar() != '/')
 			entry._path += '/';
 		entry._path += entry._displayName;
+		entry._hasStat = false;
 
 #if defined(SYSTEM_NOT_SUPPORTING_D_TYPE)
 		/* TODO: d_type is not part of POSIX, so it might not be supported
@@ -186,7 +228,7 @@ bool POSIXFilesystemNode::getChildren(AbstractFSList &myList, ListMode mode, boo
 			entry._isValid = (dp->d_type == DT_DIR) || (dp->d_type == DT_REG) || (dp->d_type == DT_LNK);
 			if (dp->d_type == DT_LNK) {
 				struct stat st;
-				if (stat(entry._path.c_str(), &st) == 0)
+				if (entry.readStat(st))
 					entry._isDirectory = S_ISDIR(st.st_mode);
 				else
 					entry._isDirectory = false;
@@ -246,6 +288,56 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return StdioStream::makeFromPath(getPath(), false);
 }
 
+#ifdef POSIX_FS_USE_MMAP
+namespace {
+
+/**
+ * MemoryReadStream over a read-only memory mapping of a file, which is
+ * unmapped when the stream is destroyed.
+ */
+class MappedReadStream : public Common::MemoryReadStream {
+	void *_mapping;
+	size_t _length;
+
+public:
+	MappedReadStream(void *mapping, size_t length)
+		: Common::MemoryReadStream((const byte *)mapping, length), _mapping(mapping), _length(length) {
+	}
+
+	~MappedReadStream() {
+		munmap(_mapping, _length);
+	}
+};
+
+} // End of anonymous namespace
+#endif
+
+Common::MemoryReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#ifdef POSIX_FS_USE_MMAP
+	const int fd = open(_path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return 0;
+
+	// Empty files cannot be mapped, and larger files than a stream can
+	// address are not supported.
+	struct stat st;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0 || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return 0;
+	}
+
+	void *mapping = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping stays valid after closing the file
+	close(fd);
+	if (mapping == MAP_FAILED)
+		return 0;
+
+	return new MappedReadStream(mapping, st.st_size);
+#else
+	return 0;
+#endif
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return StdioStream::makeFromPath(getPath(), true);
 }
@@ -41,6 +41,15 @@ protected:
 	bool _isDirectory;
 	bool _isValid;
 
+	/**
+	 * Modification time and size from the last stat() call. They are only
+	 * filled in on demand, since listing a directory does not stat() its
+	 * entries when the file type is known from readdir().
+	 */
+	mutable bool _hasStat;
+	mutable uint32 _mtime;
+	mutable int32 _fileSize;
+
 	virtual AbstractFSNode *makeNode(const Common::String &path) const {
 		return new POSIXFilesystemNode(path);
 	}
@@ -48,7 +57,7 @@ protected:
 	/**
 	 * Plain constructor, for internal use only (hence protected).
 	 */
-	POSIXFilesystemNode() : _isDirectory(false), _isValid(false) {}
+	POSIXFilesystemNode() : _isDirectory(false), _isValid(false), _hasStat(false), _mtime(0), _fileSize(-1) {}
 
 public:
 	/**
@@ -65,12 +74,15 @@ public:
 	virtual bool isDirectory() const { return _isDirectory; }
 	virtual bool isReadable() const { return access(_path.c_str(), R_OK) == 0; }
 	virtual bool isWritable() const { return access(_path.c_str(), W_OK) == 0; }
+	virtual uint32 getModificationTime() const;
+	virtual int32 getFileSize() const;
 
 	virtual AbstractFSNode *getChild(const Common::String &n) const;
 	virtual bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const;
 	virtual AbstractFSNode *getParent() const;
 
 	virtual Common::SeekableReadStream *createReadStream();
+	virtual Common::MemoryReadStream *createMappedReadStream();
 	virtual Common::WriteStream *createWriteStream();
 
 private:
@@ -78,6 +90,13 @@ private:
 	 * Tests and sets the _isValid and _isDirectory flags, using the stat() function.
 	 */
 	virtual void setFlags();
+
+	/**
+	 * Calls stat() on the path and keeps the modification time and size.
+	 *
+	 * @return true if stat() succeeded
+	 */
+	bool readStat(struct stat &st) const;
 };
 
 #endif
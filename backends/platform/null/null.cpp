@@ -20,14 +20,28 @@
  *
  */
 
+#define FORBIDDEN_SYMBOL_EXCEPTION_time_h
+
 #include "backends/modular-backend.h"
 #include "base/main.h"
 
 #if defined(USE_NULL_DRIVER)
+#include "backends/events/default/default-events.h"
+#include "backends/graphics/null/null-graphics.h"
+#include "backends/mutex/null/null-mutex.h"
 #include "backends/saves/default/default-saves.h"
 #include "backends/timer/default/default-timer.h"
 #include "audio/mixer_intern.h"
+#include "common/bufferedstream.h"
+#include "common/config-manager.h"
+#include "common/EventRecorder.h"
+#include "common/profiler.h"
 #include "common/scummsys.h"
+#include "graphics/surface.h"
+
+#if defined(POSIX)
+#include <sys/time.h>
+#endif
 
 /*
  * Include header files needed for the getFilesystemFactory() method.
@@ -40,7 +54,98 @@
 	#include "backends/fs/windows/windows-fs-factory.h"
 #endif
 
-class OSystem_NULL : public ModularBackend {
+/**
+ * Graphics manager used for benchmarking. It keeps the game screen in memory
+ * and converts it to a 32bpp frame on every screen update, which roughly
+ * resembles the work a real backend does.
+ */
+class BenchmarkGraphicsManager : public NullGraphicsManager {
+public:
+	BenchmarkGraphicsManager() : _frame(0) {
+		memset(_palette, 0, sizeof(_palette));
+		memset(_colors, 0, sizeof(_colors));
+	}
+
+	virtual ~BenchmarkGraphicsManager() {
+		_screen.free();
+		delete[] _frame;
+	}
+
+	Graphics::PixelFormat getScreenFormat() const { return _screen.format; }
+
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const {
+		Common::List<Graphics::PixelFormat> list;
+		list.push_back(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0));
+		list.push_back(Graphics::PixelFormat::createFormatCLUT8());
+		return list;
+	}
+
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {
+		_screen.free();
+		_screen.create(width, height, format ? *format : Graphics::PixelFormat::createFormatCLUT8());
+
+		delete[] _frame;
+		_frame = new uint32[width * height];
+	}
+
+	int16 getHeight() { return _screen.h; }
+	int16 getWidth() { return _screen.w; }
+
+	void setPalette(const byte *colors, uint start, uint num) {
+		memcpy(_palette + start * 3, colors, num * 3);
+		for (uint i = start; i < start + num; ++i)
+			_colors[i] = (_palette[i * 3] << 16) | (_palette[i * 3 + 1] << 8) | _palette[i * 3 + 2];
+	}
+
+	void grabPalette(byte *colors, uint start, uint num) {
+		memcpy(colors, _palette + start * 3, num * 3);
+	}
+
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+		const byte *src = (const byte *)buf;
+		byte *dst = (byte *)_screen.getBasePtr(x, y);
+		for (int i = 0; i < h; ++i) {
+			memcpy(dst, src, w * _screen.format.bytesPerPixel);
+			src += pitch;
+			dst += _screen.pitch;
+		}
+	}
+
+	Graphics::Surface *lockScreen() { return &_screen; }
+
+	void fillScreen(uint32 col) {
+		_screen.fillRect(Common::Rect(_screen.w, _screen.h), col);
+	}
+
+	void updateScreen() {
+		if (!_frame)
+			return;
+
+		uint32 *dst = _frame;
+		for (int y = 0; y < _screen.h; ++y) {
+			if (_screen.format.bytesPerPixel == 1) {
+				const byte *src = (const byte *)_screen.getBasePtr(0, y);
+				for (int x = 0; x < _screen.w; ++x)
+					*dst++ = _colors[src[x]];
+			} else {
+				const uint16 *src = (const uint16 *)_screen.getBasePtr(0, y);
+				for (int x = 0; x < _screen.w; ++x) {
+					uint8 r, g, b;
+					_screen.format.colorToRGB(src[x], r, g, b);
+					*dst++ = (r << 16) | (g << 8) | b;
+				}
+			}
+		}
+	}
+
+private:
+	Graphics::Surface _screen;
+	uint32 *_frame;
+	byte _palette[256 * 3];
+	uint32 _colors[256];
+};
+
+class OSystem_NULL : public ModularBackend, Common::EventSource {
 public:
 	OSystem_NULL();
 	virtual ~OSystem_NULL();
@@ -48,15 +153,41 @@ public:
 	virtual void initBackend();
 
 	virtual bool pollEvent(Common::Event &event);
+	virtual Common::EventSource *getDefaultEventSource() { return this; }
 
 	virtual uint32 getMillis();
 	virtual void delayMillis(uint msecs);
 	virtual void getTimeAndDate(TimeDate &t) const {}
 
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h);
+	virtual void fillScreen(uint32 col);
+	virtual void updateScreen();
+
 	virtual void logMessage(LogMessageType::Type type, const char *message);
+
+	/** Print the timings of a benchmark run, if one was done. */
+	void printBenchmarkReport();
+
+private:
+	/**
+	 * Advance the virtual clock used in benchmark mode, running the timers
+	 * and mixing the audio which falls into the elapsed time.
+	 */
+	void advanceTime(uint msecs);
+
+	static uint64 getBenchmarkClock();
+
+	bool _benchmark;
+	/** Length of the benchmark in milliseconds of game time, 0 for no limit */
+	uint32 _benchmarkLength;
+	bool _quitSent;
+	uint32 _millis;
+	uint64 _framesMixed;
+	uint32 _screenUpdates;
 };
 
-OSystem_NULL::OSystem_NULL() {
+OSystem_NULL::OSystem_NULL() : _benchmark(false), _benchmarkLength(0), _quitSent(false),
+	_millis(0), _framesMixed(0), _screenUpdates(0) {
 	#if defined(__amigaos4__)
 		_fsFactory = new AmigaOSFilesystemFactory();
 	#elif defined(POSIX)
@@ -72,31 +203,133 @@ OSystem_NULL::~OSystem_NULL() {
 }
 
 void OSystem_NULL::initBackend() {
+	// In benchmark mode the game runs on a virtual clock, which only moves
+	// forward when the game waits. Combined with the event recorder, this
+	// allows replaying a recorded session as fast as possible.
+	_benchmark = ConfMan.hasKey("benchmark");
+	if (_benchmark)
+		_benchmarkLength = ConfMan.getInt("benchmark") * 1000;
+
 	_mutexManager = new NullMutexManager();
 	_timerManager = new DefaultTimerManager();
 	_eventManager = new DefaultEventManager(this);
 	_savefileManager = new DefaultSaveFileManager();
-	_graphicsManager = new NullGraphicsManager();
+	if (_benchmark)
+		_graphicsManager = new BenchmarkGraphicsManager();
+	else
+		_graphicsManager = new NullGraphicsManager();
 	_mixer = new Audio::MixerImpl(this, 22050);
 
-	((Audio::MixerImpl *)_mixer)->setReady(false);
-
 	// Note that both the mixer and the timer manager are useless
 	// this way; they need to be hooked into the system somehow to
 	// be functional. Of course, can't do that in a NULL backend :).
+	// Except for benchmark mode, where both are driven by advanceTime().
+	((Audio::MixerImpl *)_mixer)->setReady(_benchmark);
 
 	ModularBackend::initBackend();
+
+	if (_benchmark)
+		Common::Profiler::instance().start(&getBenchmarkClock);
 }
 
 bool OSystem_NULL::pollEvent(Common::Event &event) {
+	if (!_benchmark)
+		return false;
+
+	// Let busy waiting loops make progress
+	advanceTime(1);
+
+	if (_benchmarkLength && _millis >= _benchmarkLength && !_quitSent) {
+		event.type = Common::EVENT_QUIT;
+		_quitSent = true;
+		return true;
+	}
+
 	return false;
 }
 
 uint32 OSystem_NULL::getMillis() {
-	return 0;
+	if (!_benchmark)
+		return 0;
+
+	uint32 millis = _millis;
+	g_eventRec.processMillis(millis);
+	return millis;
 }
 
 void OSystem_NULL::delayMillis(uint msecs) {
+	if (_benchmark)
+		advanceTime(msecs);
+}
+
+void OSystem_NULL::advanceTime(uint msecs) {
+	_millis += msecs;
+
+	((DefaultTimerManager *)_timerManager)->handler();
+
+	Audio::MixerImpl *mixer = (Audio::MixerImpl *)_mixer;
+	const uint64 frames = (uint64)_millis * mixer->getOutputRate() / 1000;
+
+	Common::ProfileScope profile(Common::kProfileAudio);
+	int16 buffer[2 * 1024];
+	while (_framesMixed < frames) {
+		const uint count = MIN<uint64>(frames - _framesMixed, 1024);
+		mixer->mixCallback((byte *)buffer, count * 4);
+		_framesMixed += count;
+	}
+}
+
+void OSystem_NULL::copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {
+	Common::ProfileScope profile(Common::kProfileGraphics);
+	ModularBackend::copyRectToScreen(buf, pitch, x, y, w, h);
+}
+
+void OSystem_NULL::fillScreen(uint32 col) {
+	Common::ProfileScope profile(Common::kProfileGraphics);
+	ModularBackend::fillScreen(col);
+}
+
+void OSystem_NULL::updateScreen() {
+	Common::ProfileScope profile(Common::kProfileScreenUpdate);
+	ModularBackend::updateScreen();
+	++_screenUpdates;
+}
+
+uint64 OSystem_NULL::getBenchmarkClock() {
+#if defined(POSIX)
+	timeval tv;
+	gettimeofday(&tv, 0);
+	return (uint64)tv.tv_sec * 1000000 + tv.tv_usec;
+#else
+	return 0;
+#endif
+}
+
+void OSystem_NULL::printBenchmarkReport() {
+	if (!_benchmark)
+		return;
+
+	Common::Profiler &profiler = Common::Profiler::instance();
+	profiler.stop();
+
+	const uint64 total = profiler.getTotalTime();
+	logMessage(LogMessageType::kInfo, Common::String::format(
+		"Benchmark: %u ms of game time in %u ms, %u screen updates\n",
+		_millis, (uint32)(total / 1000), _screenUpdates).c_str());
+
+	for (int i = 0; i < Common::kProfileSectionCount; ++i) {
+		const Common::ProfileSection section = (Common::ProfileSection)i;
+		const uint64 time = profiler.getTime(section);
+		logMessage(LogMessageType::kInfo, Common::String::format(
+			"  %-14s %8u ms %5.1f%% %10u calls\n",
+			Common::Profiler::getSectionName(section), (uint32)(time / 1000),
+			total ? time * 100.0 / total : 0.0, profiler.getCalls(section)).c_str());
+	}
+
+	const Common::BufferedReadStats &buffered = Common::getBufferedReadStats();
+	logMessage(LogMessageType::kInfo, Common::String::format(
+		"Buffered streams: %u KB read, %u KB delivered\n",
+		(uint32)(buffered.bytesFetched / 1024), (uint32)(buffered.bytesDelivered / 1024)).c_str());
 }
 
 void OSystem_NULL::logMessage(LogMessageType::Type type, const char *message) {
@@ -121,6 +354,7 @@ int main(int argc, char *argv[]) {
 
 	// Invoke the actual ScummVM main entry point:
 	int res = scummvm_main(argc, argv);
+	((OSystem_NULL *)g_system)->printBenchmarkReport();
 	delete (OSystem_NULL *)g_system;
 	return res;
 }
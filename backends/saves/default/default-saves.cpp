@@ -31,19 +31,219 @@
 #include "common/fs.h"
 #include "common/archive.h"
 #include "common/config-manager.h"
+#include "common/debug.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/system.h"
+#include "common/timer.h"
 #include "common/zlib.h"
 
 #ifndef _WIN32_WCE
 #include <errno.h>	// for removeSavefile()
 #endif
 
-DefaultSaveFileManager::DefaultSaveFileManager() {
+/**
+ * Writes savefiles collected in memory to their files, a chunk at a time,
+ * from a timer proc. The timer proc is only installed while there are
+ * queued savefiles.
+ */
+class BackgroundSaveWriter {
+public:
+	BackgroundSaveWriter();
+	~BackgroundSaveWriter();
+
+	/**
+	 * Queue data for writing. The writer takes ownership of the file and
+	 * of the malloc'ed data.
+	 */
+	void submit(Common::WriteStream *file, byte *data, uint32 size, const Common::String &name);
+
+	/** Write all queued data on the calling thread. */
+	void flush();
+
+private:
+	enum {
+		/** Number of bytes compressed and written per timer call */
+		kChunkSize = 64 * 1024,
+		/** Interval between timer calls in microseconds */
+		kWriteInterval = 10 * 1000
+	};
+
+	struct Job {
+		Common::WriteStream *file;
+		byte *data;
+		uint32 size;
+		uint32 pos;
+		Common::String name;
+	};
+
+	typedef Common::List<Job> JobList;
+
+	static void timerProc(void *refCon);
+
+	/**
+	 * Write up to maxBytes of the first queued job, and remove the job
+	 * once it is complete. Must be called with the mutex held.
+	 */
+	void writeChunk(uint32 maxBytes);
+
+	Common::Mutex _mutex;
+	JobList _jobs;
+	bool _timerInstalled;	///< Protected by _mutex
+};
+
+BackgroundSaveWriter::BackgroundSaveWriter() : _timerInstalled(false) {
+}
+
+BackgroundSaveWriter::~BackgroundSaveWriter() {
+	// The timer proc may be removing itself right now, so remove it
+	// regardless of _timerInstalled, which does nothing if it is gone.
+	if (g_system->getTimerManager())
+		g_system->getTimerManager()->removeTimerProc(&timerProc);
+	flush();
+}
+
+void BackgroundSaveWriter::submit(Common::WriteStream *file, byte *data, uint32 size, const Common::String &name) {
+	Job job;
+	job.file = file;
+	job.data = data;
+	job.size = size;
+	job.pos = 0;
+	job.name = name;
+
+	bool installTimer;
+	{
+		Common::StackLock lock(_mutex);
+		_jobs.push_back(job);
+		installTimer = !_timerInstalled;
+		_timerInstalled = true;
+	}
+
+	// Install the timer without holding our lock, since the timer manager
+	// holds its own lock while calling timerProc, which takes ours. If
+	// timerProc is just removing itself, installing waits for that.
+	if (installTimer && !g_system->getTimerManager()->installTimerProc(&timerProc, kWriteInterval, this, "BackgroundSaveWriter")) {
+		{
+			Common::StackLock lock(_mutex);
+			_timerInstalled = false;
+		}
+		flush();
+	}
+}
+
+void BackgroundSaveWriter::flush() {
+	Common::StackLock lock(_mutex);
+	while (!_jobs.empty())
+		writeChunk(0xFFFFFFFF);
 }
 
-DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) {
+void BackgroundSaveWriter::timerProc(void *refCon) {
+	BackgroundSaveWriter *writer = (BackgroundSaveWriter *)refCon;
+
+	{
+		Common::StackLock lock(writer->_mutex);
+		if (!writer->_jobs.empty())
+			writer->writeChunk(kChunkSize);
+		if (!writer->_jobs.empty())
+			return;
+		writer->_timerInstalled = false;
+	}
+
+	// Nothing left to write, so stop calling us until the next submit()
+	g_system->getTimerManager()->removeTimerProc(&timerProc);
+}
+
+void BackgroundSaveWriter::writeChunk(uint32 maxBytes) {
+	Job &job = _jobs.front();
+
+	const uint32 len = MIN(job.size - job.pos, maxBytes);
+	if (job.file->write(job.data + job.pos, len) != len)
+		job.pos = job.size;
+	else
+		job.pos += len;
+
+	if (job.pos < job.size)
+		return;
+
+	job.file->finalize();
+	if (job.file->err())
+		warning("Could not write savefile '%s'", job.name.c_str());
+	else
+		debug(1, "Savefile '%s' written in the background", job.name.c_str());
+
+	delete job.file;
+	free(job.data);
+	_jobs.pop_front();
+}
+
+namespace {
+
+/**
+ * Savefile which collects the data in memory and passes it on to a
+ * BackgroundSaveWriter when finalized.
+ */
+class BackgroundSaveFile : public Common::WriteStream {
+public:
+	BackgroundSaveFile(BackgroundSaveWriter *writer, Common::WriteStream *file, const Common::String &name)
+		: _writer(writer), _file(file), _name(name) {}
+
+	~BackgroundSaveFile() {
+		finalize();
+	}
+
+	virtual uint32 write(const void *dataPtr, uint32 dataSize) {
+		if (!_file)
+			return 0;
+		return _buffer.write(dataPtr, dataSize);
+	}
+
+	virtual bool err() const {
+		return _file && _file->err();
+	}
+
+	virtual void finalize() {
+		if (!_file)
+			return;
+
+		_writer->submit(_file, _buffer.getData(), _buffer.size(), _name);
+		_file = 0;
+	}
+
+private:
+	BackgroundSaveWriter *_writer;
+	Common::WriteStream *_file;
+	Common::String _name;
+	/** The collected data; its memory is handed over to the writer */
+	Common::MemoryWriteStreamDynamic _buffer;
+};
+
+} // End of anonymous namespace
+
+DefaultSaveFileManager::DefaultSaveFileManager() : _backgroundWriter(0), _revision(1) {
+}
+
+DefaultSaveFileManager::DefaultSaveFileManager(const Common::String &defaultSavepath) : _backgroundWriter(0), _revision(1) {
 	ConfMan.registerDefault("savepath", defaultSavepath);
 }
 
+DefaultSaveFileManager::~DefaultSaveFileManager() {
+	delete _backgroundWriter;
+}
+
+void DefaultSaveFileManager::flushBackgroundSaves() {
+	if (_backgroundWriter)
+		_backgroundWriter->flush();
+}
+
+void DefaultSaveFileManager::finishBackgroundSaves() {
+	// The writer owns a mutex, which must be deleted while the backend
+	// can still do so; on some backends this is no longer the case when
+	// the savefile manager is destroyed.
+	delete _backgroundWriter;
+	_backgroundWriter = 0;
+}
+
 
 void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 	clearError();
@@ -55,6 +255,8 @@ void DefaultSaveFileManager::checkPath(const Common::FSNode &dir) {
 }
 
 Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &pattern) {
+	flushBackgroundSaves();
+
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError().getCode() != Common::kNoError)
@@ -78,6 +280,8 @@ Common::StringArray DefaultSaveFileManager::listSavefiles(const Common::String &
 }
 
 Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String &filename) {
+	flushBackgroundSaves();
+
 	// Ensure that the savepath is valid. If not, generate an appropriate error.
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
@@ -98,6 +302,9 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 }
 
 Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String &filename, bool compress) {
+	flushBackgroundSaves();
+	++_revision;
+
 	// Ensure that the savepath is valid. If not, generate an appropriate error.
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
@@ -115,7 +322,21 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	return compress ? Common::wrapCompressedWriteStream(sf) : sf;
 }
 
+Common::OutSaveFile *DefaultSaveFileManager::openForSavingInBackground(const Common::String &filename, bool compress) {
+	Common::OutSaveFile *file = openForSaving(filename, compress);
+	if (!file)
+		return 0;
+
+	if (!_backgroundWriter)
+		_backgroundWriter = new BackgroundSaveWriter();
+
+	return new BackgroundSaveFile(_backgroundWriter, file, filename);
+}
+
 bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
+	flushBackgroundSaves();
+	++_revision;
+
 	Common::String savePathName = getSavePath();
 	checkPath(Common::FSNode(savePathName));
 	if (getError().getCode() != Common::kNoError)
@@ -28,6 +28,8 @@
 #include "common/str.h"
 #include "common/fs.h"
 
+class BackgroundSaveWriter;
+
 /**
  * Provides a default savefile manager implementation for common platforms.
  */
@@ -35,11 +37,15 @@ class DefaultSaveFileManager : public Common::SaveFileManager {
 public:
 	DefaultSaveFileManager();
 	DefaultSaveFileManager(const Common::String &defaultSavepath);
+	virtual ~DefaultSaveFileManager();
 
 	virtual Common::StringArray listSavefiles(const Common::String &pattern);
 	virtual Common::InSaveFile *openForLoading(const Common::String &filename);
 	virtual Common::OutSaveFile *openForSaving(const Common::String &filename, bool compress = true);
+	virtual Common::OutSaveFile *openForSavingInBackground(const Common::String &filename, bool compress = true);
+	virtual void finishBackgroundSaves();
 	virtual bool removeSavefile(const Common::String &filename);
+	virtual uint32 getRevision() const { return _revision; }
 
 protected:
 	/**
@@ -54,6 +60,17 @@ protected:
 	 * Sets the internal error and error message accordingly.
 	 */
 	virtual void checkPath(const Common::FSNode &dir);
+
+	/**
+	 * Wait until all savefiles saved in the background have been written.
+	 * Called before accessing the savefiles, so that no incomplete files
+	 * are read or overwritten.
+	 */
+	void flushBackgroundSaves();
+
+private:
+	BackgroundSaveWriter *_backgroundWriter;
+	uint32 _revision;
 };
 
 #endif
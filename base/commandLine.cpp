@@ -136,6 +136,11 @@ static const char HELP_STRING[] =
 	"  --dimuse-tempo=NUM       Set internal Digital iMuse tempo (10 - 100) per second\n"
 	"                           (default: 10)\n"
 #endif
+#endif
+#ifdef USE_NULL_DRIVER
+	"  --benchmark[=SECS]       Run on a virtual clock as fast as possible and print\n"
+	"                           subsystem timings on exit, quitting after SECS\n"
+	"                           seconds of game time if given\n"
 #endif
 	"\n"
 	"The meaning of boolean long options can be inverted by prefixing them with\n"
@@ -581,6 +586,11 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION("record-time-file-name")
 			END_OPTION
 
+#ifdef USE_NULL_DRIVER
+			DO_LONG_OPTION_OPT("benchmark", "0")
+			END_OPTION
+#endif
+
 #ifdef IPHONE
 			// This is automatically set when launched from the Springboard.
 			DO_LONG_OPTION_OPT("launchedFromSB", 0)
@@ -444,6 +444,7 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 // Engine plugins
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 
 namespace Common {
@@ -518,6 +519,8 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 	GameList candidates;
 	EnginePlugin::List plugins;
 	EnginePlugin::List::const_iterator iter;
+	// Let all engines share the checksums computed during this pass
+	DetectionCache::instance().beginScan();
 	PluginManager::instance().loadFirstPlugin();
 	do {
 		plugins = getPlugins();
@@ -527,6 +530,7 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 			candidates.push_back((**iter)->detectGames(fslist));
 		}
 	} while (PluginManager::instance().loadNextPlugin());
+	DetectionCache::instance().endScan();
 	return candidates;
 }
 
@@ -21,9 +21,11 @@
  */
 
 #include "common/archive.h"
+#include "common/algorithm.h"
 #include "common/fs.h"
 #include "common/system.h"
 #include "common/textconsole.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -62,6 +64,12 @@ int Archive::listMatchingMembers(ArchiveMemberList &list, const String &pattern)
 
 
 
+volatile uint32 SearchSet::_changes = 0;
+
+SearchSet::SearchSet() : _indexRevision(0), _indexValid(false) {
+	resetIndexStats();
+}
+
 SearchSet::ArchiveNodeList::iterator SearchSet::find(const String &name) {
 	ArchiveNodeList::iterator it = _list.begin();
 	for ( ; it != _list.end(); ++it) {
@@ -92,9 +100,12 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	_changes++;
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
+	StackLock lock(_mutex);
+
 	if (find(name) == _list.end()) {
 		Node node(priority, name, archive, autoFree);
 		insert(node);
@@ -169,8 +180,11 @@ void SearchSet::addSubDirectoriesMatching(const FSNode &directory, String origPa
 }
 
 void SearchSet::remove(const String &name) {
+	StackLock lock(_mutex);
+
 	ArchiveNodeList::iterator it = find(name);
 	if (it != _list.end()) {
+		_changes++;
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
@@ -178,19 +192,28 @@ void SearchSet::remove(const String &name) {
 }
 
 bool SearchSet::hasArchive(const String &name) const {
+	StackLock lock(_mutex);
 	return (find(name) != _list.end());
 }
 
 void SearchSet::clear() {
+	StackLock lock(_mutex);
+	_changes++;
+
 	for (ArchiveNodeList::iterator i = _list.begin(); i != _list.end(); ++i) {
 		if (i->_autoFree)
 			delete i->_arc;
 	}
 
 	_list.clear();
+	_index.clear(true);
+	_unlistedArchives.clear();
+	_indexValid = false;
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
+	StackLock lock(_mutex);
+
 	ArchiveNodeList::iterator it = find(name);
 	if (it == _list.end()) {
 		warning("SearchSet::setPriority: archive '%s' is not present", name.c_str());
@@ -206,12 +229,88 @@ void SearchSet::setPriority(const String &name, int priority) {
 	insert(node);
 }
 
+void SearchSet::resetIndexStats() {
+	StackLock lock(_mutex);
+	memset(&_indexStats, 0, sizeof(_indexStats));
+}
+
+void SearchSet::updateIndex() const {
+	// Another SearchSet may be changed while the index is built, in which
+	// case the index is built again on the next lookup.
+	const uint32 revision = _changes;
+	if (_indexValid && revision == _indexRevision)
+		return;
+
+	const uint32 start = g_system ? g_system->getMillis() : 0;
+
+	_index.clear();
+	_unlistedArchives.clear();
+
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for ( ; it != _list.end(); ++it) {
+		if (!it->_arc->listsAllMembers()) {
+			_unlistedArchives.push_back(it->_arc);
+			continue;
+		}
+
+		ArchiveMemberList members;
+		it->_arc->listMembers(members);
+
+		for (ArchiveMemberList::const_iterator m = members.begin(); m != members.end(); ++m) {
+			const String name = (*m)->getName();
+			if (name.contains('/'))
+				continue;
+
+			ArchiveArray &archives = _index[name];
+			if (archives.empty() || archives.back() != it->_arc)
+				archives.push_back(it->_arc);
+		}
+	}
+
+	_indexRevision = revision;
+	_indexValid = true;
+	_indexStats.rebuilds++;
+	if (g_system)
+		_indexStats.buildTime += g_system->getMillis() - start;
+}
+
+const SearchSet::ArchiveArray *SearchSet::lookupIndex(const String &name) const {
+	_indexStats.lookups++;
+
+	// Archives may accept paths into sub directories they do not list,
+	// like FSDirectory, so we can only rule them out for plain names.
+	if (name.contains('/'))
+		return 0;
+
+	updateIndex();
+	_indexStats.indexed++;
+
+	static const ArchiveArray noArchives;
+	MemberIndex::const_iterator i = _index.find(name);
+	return (i != _index.end()) ? &i->_value : &noArchives;
+}
+
+bool SearchSet::mayContain(const Archive *archive, const ArchiveArray *listed) const {
+	if (!listed)
+		return true;
+
+	return Common::find(listed->begin(), listed->end(), archive) != listed->end()
+		|| Common::find(_unlistedArchives.begin(), _unlistedArchives.end(), archive) != _unlistedArchives.end();
+}
+
 bool SearchSet::hasFile(const String &name) const {
 	if (name.empty())
 		return false;
 
+	StackLock lock(_mutex);
+	const ArchiveArray *listed = lookupIndex(name);
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for ( ; it != _list.end(); ++it) {
+		if (!mayContain(it->_arc, listed))
+			continue;
+
+		_indexStats.probes++;
 		if (it->_arc->hasFile(name))
 			return true;
 	}
@@ -220,16 +319,42 @@ bool SearchSet::hasFile(const String &name) const {
 }
 
 int SearchSet::listMatchingMembers(ArchiveMemberList &list, const String &pattern) const {
+	StackLock lock(_mutex);
 	int matches = 0;
 
+	// Only archives listing a matching name, and those which do not list all
+	// their members, can have any matches. This does not hold for patterns
+	// with path separators, see lookupIndex().
+	ArchiveArray candidates;
+	const bool useIndex = !pattern.contains('/');
+	if (useIndex) {
+		updateIndex();
+		candidates = _unlistedArchives;
+
+		for (MemberIndex::const_iterator i = _index.begin(); i != _index.end(); ++i) {
+			if (!i->_key.matchString(pattern, true, true))
+				continue;
+
+			for (uint j = 0; j < i->_value.size(); ++j) {
+				if (Common::find(candidates.begin(), candidates.end(), i->_value[j]) == candidates.end())
+					candidates.push_back(i->_value[j]);
+			}
+		}
+	}
+
 	ArchiveNodeList::const_iterator it = _list.begin();
-	for ( ; it != _list.end(); ++it)
+	for ( ; it != _list.end(); ++it) {
+		if (useIndex && Common::find(candidates.begin(), candidates.end(), it->_arc) == candidates.end())
+			continue;
+
 		matches += it->_arc->listMatchingMembers(list, pattern);
+	}
 
 	return matches;
 }
 
 int SearchSet::listMembers(ArchiveMemberList &list) const {
+	StackLock lock(_mutex);
 	int matches = 0;
 
 	ArchiveNodeList::const_iterator it = _list.begin();
@@ -239,12 +364,30 @@ int SearchSet::listMembers(ArchiveMemberList &list) const {
 	return matches;
 }
 
+bool SearchSet::listsAllMembers() const {
+	StackLock lock(_mutex);
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for ( ; it != _list.end(); ++it) {
+		if (!it->_arc->listsAllMembers())
+			return false;
+	}
+
+	return true;
+}
+
 const ArchiveMemberPtr SearchSet::getMember(const String &name) const {
 	if (name.empty())
 		return ArchiveMemberPtr();
 
+	StackLock lock(_mutex);
+	const ArchiveArray *listed = lookupIndex(name);
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for ( ; it != _list.end(); ++it) {
+		if (!mayContain(it->_arc, listed))
+			continue;
+
+		_indexStats.probes++;
 		if (it->_arc->hasFile(name))
 			return it->_arc->getMember(name);
 	}
@@ -256,8 +399,15 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	if (name.empty())
 		return 0;
 
+	StackLock lock(_mutex);
+	const ArchiveArray *listed = lookupIndex(name);
+
 	ArchiveNodeList::const_iterator it = _list.begin();
 	for ( ; it != _list.end(); ++it) {
+		if (!mayContain(it->_arc, listed))
+			continue;
+
+		_indexStats.probes++;
 		SeekableReadStream *stream = it->_arc->createReadStreamForMember(name);
 		if (stream)
 			return stream;
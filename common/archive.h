@@ -24,7 +24,11 @@
 #define COMMON_ARCHIVE_H
 
 #include "common/str.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/list.h"
+#include "common/mutex.h"
 #include "common/ptr.h"
 #include "common/singleton.h"
 
@@ -106,6 +110,14 @@ public:
 	 */
 	virtual int listMembers(ArchiveMemberList &list) const = 0;
 
+	/**
+	 * Check if every name without a path separator accepted by hasFile()
+	 * is listed by listMembers(). SearchSet does not search such archives
+	 * for names they do not list. Archives which accept names they do not
+	 * list, for example by generating them, must return false.
+	 */
+	virtual bool listsAllMembers() const { return false; }
+
 	/**
 	 * Returns a ArchiveMember representation of the given file.
 	 */
@@ -126,8 +138,27 @@ public:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet *DOES* guarantee that searches are performed in *DESCENDING*
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * To avoid asking every archive for every file, SearchSet keeps an index of
+ * the members of all its archives, which is built on the first lookup after
+ * any SearchSet changed, so that changes to nested SearchSets are noticed.
+ * Only archives listing a member of the requested name are searched. Names
+ * containing a path separator are still looked up in all archives.
+ *
+ * The archive list, the index and the statistics are guarded by a mutex, so
+ * a SearchSet may be searched from a timer thread while it is modified.
  */
 class SearchSet : public Archive {
+public:
+	struct IndexStats {
+		uint32 lookups;		///< Number of member lookups
+		uint32 indexed;		///< Number of lookups answered through the index
+		uint32 probes;		///< Number of archives searched by all lookups
+		uint32 rebuilds;	///< Number of times the index was built
+		uint32 buildTime;	///< Total time spent building the index, in ms
+	};
+
+private:
 	struct Node {
 		int		_priority;
 		String	_name;
@@ -146,7 +177,44 @@ class SearchSet : public Archive {
 	// Add an archive keeping the list sorted by descending priority.
 	void insert(const Node& node);
 
+	typedef Array<Archive *> ArchiveArray;
+	typedef HashMap<String, ArchiveArray, IgnoreCase_Hash, IgnoreCase_EqualTo> MemberIndex;
+
+	/**
+	 * Archives listing each member name, in descending priority order. Only
+	 * archives which list all their members are indexed.
+	 */
+	mutable MemberIndex _index;
+	/** Archives which may contain members they do not list */
+	mutable ArchiveArray _unlistedArchives;
+	/** Value of _changes when the index was built */
+	mutable uint32 _indexRevision;
+	mutable bool _indexValid;
+	mutable IndexStats _indexStats;
+	mutable Mutex _mutex;
+
+	/**
+	 * Increased whenever the list of archives of any SearchSet changes.
+	 * Archives may be SearchSets themselves, so a change to any of them
+	 * can change the members of another one.
+	 */
+	static volatile uint32 _changes;
+
+	/**
+	 * Return the archives which list the given member, after bringing the
+	 * index up to date. Returns 0 if all archives must be searched.
+	 */
+	const ArchiveArray *lookupIndex(const String &name) const;
+	/**
+	 * Check if the archive has to be searched for a member, given the
+	 * archives listing it as returned by lookupIndex().
+	 */
+	bool mayContain(const Archive *archive, const ArchiveArray *listed) const;
+	/** Rebuild the index if any SearchSet changed. Call with _mutex locked. */
+	void updateIndex() const;
+
 public:
+	SearchSet();
 	virtual ~SearchSet() { clear(); }
 
 	/**
@@ -233,6 +301,7 @@ public:
 	virtual bool hasFile(const String &name) const;
 	virtual int listMatchingMembers(ArchiveMemberList &list, const String &pattern) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
+	virtual bool listsAllMembers() const;
 
 	virtual const ArchiveMemberPtr getMember(const String &name) const;
 
@@ -241,6 +310,10 @@ public:
 	 * opening the first file encountered that matches the name.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	/** Return statistics about the member lookups since the last reset. */
+	const IndexStats &getIndexStats() const { return _indexStats; }
+	void resetIndexStats();
 };
 
 
@@ -45,11 +45,27 @@ ReadStream *wrapBufferedReadStream(ReadStream *parentStream, uint32 bufSize, Dis
  * Users can specify how big the buffer should be, and whether the wrapped
  * stream should be disposed when the wrapper is disposed.
  *
+ * The stream keeps several buffers of this size, so that seeking back to
+ * recently read data does not read it again. The buffer grows while the
+ * stream is read sequentially.
+ *
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  */
 SeekableReadStream *wrapBufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream);
 
+/**
+ * Statistics of all buffered read streams created by the functions above,
+ * since the start of the program. They are not exact when buffered streams
+ * are read from several threads.
+ */
+struct BufferedReadStats {
+	uint64 bytesFetched;	///< Number of bytes read from the wrapped streams
+	uint64 bytesDelivered;	///< Number of bytes returned to the users
+};
+
+const BufferedReadStats &getBufferedReadStats();
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which
  * transparently provides buffering.
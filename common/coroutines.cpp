@@ -24,6 +24,7 @@
 #include "common/debug.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/memorypool.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
@@ -71,6 +72,20 @@ static void displayCoroStats() {
 } // End of anonymous namespace
 #endif
 
+namespace {
+enum {
+	kContextPoolStep = 16,
+	kNumContextPools = 16
+};
+
+/**
+ * Memory pools for the contexts, one for each multiple of kContextPoolStep
+ * bytes. Like the scheduler singleton, they live until the program exits.
+ */
+static MemoryPool *s_contextPools[kNumContextPools];
+
+} // End of anonymous namespace
+
 CoroBaseContext::CoroBaseContext(const char *func)
 	: _line(0), _sleep(0), _subctx(0) {
 #ifdef COROUTINE_DEBUG
@@ -91,6 +106,30 @@ CoroBaseContext::~CoroBaseContext() {
 	delete _subctx;
 }
 
+void *CoroBaseContext::operator new(size_t size) {
+	const size_t pool = (size - 1) / kContextPoolStep;
+	if (pool >= kNumContextPools)
+		return ::operator new(size);
+
+	if (!s_contextPools[pool])
+		s_contextPools[pool] = new MemoryPool((pool + 1) * kContextPoolStep);
+	return s_contextPools[pool]->allocChunk();
+}
+
+void CoroBaseContext::operator delete(void *p, size_t size) {
+	if (!p)
+		return;
+
+	// The size is that of the actual context, thanks to the virtual destructor
+	const size_t pool = (size - 1) / kContextPoolStep;
+	if (pool >= kNumContextPools) {
+		::operator delete(p);
+		return;
+	}
+
+	s_contextPools[pool]->freeChunk(p);
+}
+
 //--------------------- Scheduler Class ------------------------
 
 CoroutineScheduler::CoroutineScheduler() {
@@ -106,6 +145,7 @@ CoroutineScheduler::CoroutineScheduler() {
 
 	pRCfunction = NULL;
 	pidCounter = 0;
+	_timerWheelTime = 0;
 
 	active = new PROCESS;
 	active->pPrevious = NULL;
@@ -130,9 +170,8 @@ CoroutineScheduler::~CoroutineScheduler() {
 	active = 0;
 
 	// Clear the event list
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i)
-		delete *i;
+	for (EventMap::iterator i = _events.begin(); i != _events.end(); ++i)
+		delete i->_value;
 }
 
 void CoroutineScheduler::reset() {
@@ -173,7 +212,12 @@ void CoroutineScheduler::reset() {
 	for (int i = 1; i <= CORO_NUM_PROCESS; i++) {
 		processList[i - 1].pNext = (i == CORO_NUM_PROCESS) ? NULL : processList + i;
 		processList[i - 1].pPrevious = (i == 1) ? active : processList + (i - 2);
+		processList[i - 1].blocked = false;
 	}
+
+	// no processes are waiting anymore
+	_waitQueues.clear();
+	Common::fill(&_timerWheel[0], &_timerWheel[kTimerWheelSlots], (PROCESS *)NULL);
 }
 
 
@@ -225,11 +269,25 @@ void CoroutineScheduler::schedule() {
 	while (pProc != NULL) {
 		pNext = pProc->pNext;
 
-		if (--pProc->sleepTime <= 0) {
+		// wake up processes whose waiting time is over, including those
+		// whose time ran out while the previous processes were running
+		const uint32 time = g_system->getMillis();
+		if (time != _timerWheelTime)
+			processTimers(time);
+
+		// blocked processes are skipped until they are woken up
+		if (!pProc->blocked && --pProc->sleepTime <= 0) {
 			// process is ready for dispatch, activate it
 			pCurrent = pProc;
+			const uint32 startTime = g_system->getMillis();
 			pProc->coroAddr(pProc->state, pProc->param);
 
+			// update the timing counters of the process
+			const uint32 runTime = g_system->getMillis() - startTime;
+			pProc->numRuns++;
+			pProc->runTime += runTime;
+			pProc->maxRunTime = MAX(pProc->maxRunTime, runTime);
+
 			if (!pProc->state || pProc->state->_sleep <= 0) {
 				// Coroutine finished
 				pCurrent = pCurrent->pPrevious;
@@ -247,13 +305,13 @@ void CoroutineScheduler::schedule() {
 	}
 
 	// Disable any events that were pulsed
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
-		if (evt->pulsing) {
+	for (uint i = 0; i < _pulsedEvents.size(); ++i) {
+		EVENT *evt = getEvent(_pulsedEvents[i]);
+		if (evt && evt->pulsing) {
 			evt->pulsing = evt->signalled = false;
 		}
 	}
+	_pulsedEvents.clear();
 }
 
 void CoroutineScheduler::rescheduleAll() {
@@ -387,7 +445,9 @@ void CoroutineScheduler::waitForSingleObject(CORO_PARAM, int pid, uint32 duratio
 			break;
 		}
 
-		// Sleep until the next cycle
+		// Sleep until the process or event changes, or the time is over
+		blockCurrentProcess(pCurrent->pidWaiting, 1,
+		                    (_ctx->endTime == CORO_INFINITE) ? CORO_INFINITE : _ctx->endTime + 1);
 		CORO_SLEEP(1);
 	}
 
@@ -454,7 +514,9 @@ void CoroutineScheduler::waitForMultipleObjects(CORO_PARAM, int nCount, uint32 *
 			break;
 		}
 
-		// Sleep until the next cycle
+		// Sleep until one of the processes or events changes, or the time is over
+		blockCurrentProcess(pCurrent->pidWaiting, nCount,
+		                    (_ctx->endTime == CORO_INFINITE) ? CORO_INFINITE : _ctx->endTime + 1);
 		CORO_SLEEP(1);
 	}
 
@@ -480,7 +542,8 @@ void CoroutineScheduler::sleep(CORO_PARAM, uint32 duration) {
 
 	// Outer loop for doing checks until expiry
 	while (g_system->getMillis() < _ctx->endTime) {
-		// Sleep until the next cycle
+		// Sleep until the time is over
+		blockCurrentProcess(NULL, 0, _ctx->endTime);
 		CORO_SLEEP(1);
 	}
 
@@ -539,6 +602,12 @@ PROCESS *CoroutineScheduler::createProcess(uint32 pid, CORO_ADDR coroAddr, const
 	// set new process id
 	pProc->pid = pid;
 
+	// the process is not waiting, and has not run yet
+	pProc->blocked = false;
+	pProc->wakeTime = CORO_INFINITE;
+	pProc->pTimerNext = pProc->pTimerPrevious = NULL;
+	pProc->numRuns = pProc->runTime = pProc->maxRunTime = 0;
+
 	// set new process specific info
 	if (sizeParam) {
 		assert(sizeParam > 0 && sizeParam <= CORO_PARAM_SIZE);
@@ -580,6 +649,9 @@ void CoroutineScheduler::killProcess(PROCESS *pKillProc) {
 	delete pKillProc->state;
 	pKillProc->state = 0;
 
+	if (pKillProc->blocked)
+		wakeProcess(pKillProc);
+
 	// Take the process out of the active chain list
 	pKillProc->pPrevious->pNext = pKillProc->pNext;
 	if (pKillProc->pNext)
@@ -593,6 +665,9 @@ void CoroutineScheduler::killProcess(PROCESS *pKillProc) {
 
 	// make pKillProc the first free process
 	pFreeProcesses = pKillProc;
+
+	// processes waiting for this one have to check whether it was the last with its Id
+	wakeWaitingProcesses(pKillProc->pid);
 }
 
 PROCESS *CoroutineScheduler::getCurrentProcess() {
@@ -609,6 +684,20 @@ int CoroutineScheduler::getCurrentPID() const {
 	return pProc->pid;
 }
 
+String CoroutineScheduler::getProcessStats() const {
+	String stats = "     PID  State       Runs   Time (ms)  Max (ms)\n";
+	for (const PROCESS *pProc = active->pNext; pProc != NULL; pProc = pProc->pNext) {
+		stats += String::format("%8u  %-7s %8u %11u %9u\n", pProc->pid, pProc->blocked ? "waiting" : "ready",
+		                        pProc->numRuns, pProc->runTime, pProc->maxRunTime);
+	}
+	return stats;
+}
+
+void CoroutineScheduler::resetProcessStats() {
+	for (PROCESS *pProc = active->pNext; pProc != NULL; pProc = pProc->pNext)
+		pProc->numRuns = pProc->runTime = pProc->maxRunTime = 0;
+}
+
 int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 	int numKilled = 0;
 	PROCESS *pProc, *pPrev; // process list pointers
@@ -629,6 +718,9 @@ int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 				delete pProc->state;
 				pProc->state = 0;
 
+				if (pProc->blocked)
+					wakeProcess(pProc);
+
 				// make prev point to next to unlink pProc
 				pPrev->pNext = pProc->pNext;
 				if (pProc->pNext)
@@ -642,6 +734,8 @@ int CoroutineScheduler::killMatchingProcess(uint32 pidKill, int pidMask) {
 				// make pProc the first free process
 				pFreeProcesses = pProc;
 
+				wakeWaitingProcesses(pProc->pid);
+
 				// set to a process on the active list
 				pProc = pPrev;
 			}
@@ -671,14 +765,102 @@ PROCESS *CoroutineScheduler::getProcess(uint32 pid) {
 }
 
 EVENT *CoroutineScheduler::getEvent(uint32 pid) {
-	Common::List<EVENT *>::iterator i;
-	for (i = _events.begin(); i != _events.end(); ++i) {
-		EVENT *evt = *i;
-		if (evt->pid == pid)
-			return evt;
+	EventMap::iterator i = _events.find(pid);
+	return (i != _events.end()) ? i->_value : NULL;
+}
+
+void CoroutineScheduler::blockCurrentProcess(const uint32 *pidList, int nCount, uint32 wakeTime) {
+	// If the timer wheel has already passed the wake-up time, simply run
+	// the process again in the next cycle
+	if (wakeTime != CORO_INFINITE && wakeTime <= _timerWheelTime)
+		return;
+
+	PROCESS *pProc = pCurrent;
+	pProc->blocked = true;
+	pProc->waitSerial++;
+	pProc->wakeTime = wakeTime;
+	if (wakeTime != CORO_INFINITE)
+		addTimer(pProc);
+
+	for (int i = 0; i < nCount; ++i) {
+		Array<WaitEntry> &queue = _waitQueues[pidList[i]];
+
+		// Remove the entries of processes which were woken up since
+		for (uint j = 0; j < queue.size();) {
+			const PROCESS *pWaiting = queue[j].pProcess;
+			if (pWaiting->blocked && pWaiting->waitSerial == queue[j].waitSerial) {
+				++j;
+			} else {
+				queue[j] = queue.back();
+				queue.pop_back();
+			}
+		}
+
+		WaitEntry entry = { pProc, pProc->waitSerial };
+		queue.push_back(entry);
+	}
+}
+
+void CoroutineScheduler::wakeProcess(PROCESS *pProc) {
+	if (pProc->wakeTime != CORO_INFINITE)
+		removeTimer(pProc);
+	pProc->blocked = false;
+}
+
+void CoroutineScheduler::wakeWaitingProcesses(uint32 pid) {
+	WaitQueueMap::iterator i = _waitQueues.find(pid);
+	if (i == _waitQueues.end())
+		return;
+
+	const Array<WaitEntry> &queue = i->_value;
+	for (uint j = 0; j < queue.size(); ++j) {
+		PROCESS *pProc = queue[j].pProcess;
+		if (pProc->blocked && pProc->waitSerial == queue[j].waitSerial)
+			wakeProcess(pProc);
 	}
 
-	return NULL;
+	_waitQueues.erase(i);
+}
+
+void CoroutineScheduler::addTimer(PROCESS *pProc) {
+	PROCESS *&pFirst = _timerWheel[(pProc->wakeTime >> kTimerWheelShift) % kTimerWheelSlots];
+
+	pProc->pTimerPrevious = NULL;
+	pProc->pTimerNext = pFirst;
+	if (pFirst)
+		pFirst->pTimerPrevious = pProc;
+	pFirst = pProc;
+}
+
+void CoroutineScheduler::removeTimer(PROCESS *pProc) {
+	if (pProc->pTimerPrevious)
+		pProc->pTimerPrevious->pTimerNext = pProc->pTimerNext;
+	else
+		_timerWheel[(pProc->wakeTime >> kTimerWheelShift) % kTimerWheelSlots] = pProc->pTimerNext;
+
+	if (pProc->pTimerNext)
+		pProc->pTimerNext->pTimerPrevious = pProc->pTimerPrevious;
+	pProc->pTimerNext = pProc->pTimerPrevious = NULL;
+}
+
+void CoroutineScheduler::processTimers(uint32 time) {
+	// Check every slot passed since the last call, but each slot only once
+	const uint32 firstSlot = _timerWheelTime >> kTimerWheelShift;
+	uint32 numSlots = (time >> kTimerWheelShift) - firstSlot + 1;
+	if (numSlots > kTimerWheelSlots)
+		numSlots = kTimerWheelSlots;
+
+	for (uint32 slot = firstSlot; slot < firstSlot + numSlots; ++slot) {
+		PROCESS *pProc = _timerWheel[slot % kTimerWheelSlots];
+		while (pProc != NULL) {
+			PROCESS *pNext = pProc->pTimerNext;
+			if (pProc->wakeTime <= time)
+				wakeProcess(pProc);
+			pProc = pNext;
+		}
+	}
+
+	_timerWheelTime = time;
 }
 
 
@@ -689,22 +871,25 @@ uint32 CoroutineScheduler::createEvent(bool bManualReset, bool bInitialState) {
 	evt->signalled = bInitialState;
 	evt->pulsing = false;
 
-	_events.push_back(evt);
+	_events[evt->pid] = evt;
 	return evt->pid;
 }
 
 void CoroutineScheduler::closeEvent(uint32 pidEvent) {
 	EVENT *evt = getEvent(pidEvent);
 	if (evt) {
-		_events.remove(evt);
+		_events.erase(pidEvent);
 		delete evt;
+		wakeWaitingProcesses(pidEvent);
 	}
 }
 
 void CoroutineScheduler::setEvent(uint32 pidEvent) {
 	EVENT *evt = getEvent(pidEvent);
-	if (evt)
+	if (evt) {
 		evt->signalled = true;
+		wakeWaitingProcesses(pidEvent);
+	}
 }
 
 void CoroutineScheduler::resetEvent(uint32 pidEvent) {
@@ -721,6 +906,8 @@ void CoroutineScheduler::pulseEvent(uint32 pidEvent) {
 	// Set the event as signalled and pulsing
 	evt->signalled = true;
 	evt->pulsing = true;
+	_pulsedEvents.push_back(pidEvent);
+	wakeWaitingProcesses(pidEvent);
 
 	// If there's an active process, and it's not the first in the queue, then reschedule all
 	// the other prcoesses in the queue to run again this frame
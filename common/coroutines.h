@@ -24,8 +24,11 @@
 
 #include "common/scummsys.h"
 #include "common/util.h"    // for SCUMMVM_CURRENT_FUNCTION
+#include "common/array.h"
+#include "common/hashmap.h"
 #include "common/list.h"
 #include "common/singleton.h"
+#include "common/str.h"
 
 namespace Common {
 
@@ -65,6 +68,13 @@ struct CoroBaseContext {
 	 * Destructor for coroutine context
 	 */
 	virtual ~CoroBaseContext();
+
+	/**
+	 * Contexts are created on every coroutine invocation, so they are
+	 * allocated from memory pools for their size instead of the heap.
+	 */
+	static void *operator new(size_t size);
+	static void operator delete(void *p, size_t size);
 };
 
 typedef CoroBaseContext *CoroContext;
@@ -307,6 +317,16 @@ struct PROCESS {
 	uint32 pid;         ///< process ID
 	uint32 pidWaiting[CORO_MAX_PID_WAITING];    ///< Process ID(s) process is currently waiting on
 	char param[CORO_PARAM_SIZE];    ///< process specific info
+
+	bool blocked;       ///< process is waiting and not run until woken up
+	uint32 waitSerial;  ///< number of the current wait, to recognize outdated wait queue entries
+	uint32 wakeTime;    ///< time at which a blocked process is woken up, or CORO_INFINITE
+	PROCESS *pTimerNext;        ///< next process in the same timer wheel slot
+	PROCESS *pTimerPrevious;    ///< previous process in the same timer wheel slot
+
+	uint32 numRuns;     ///< number of times the process was run
+	uint32 runTime;     ///< total time spent running the process, in milliseconds (1 ms resolution)
+	uint32 maxRunTime;  ///< longest time spent in a single run, in milliseconds (1 ms resolution)
 };
 typedef PROCESS *PPROCESS;
 
@@ -357,8 +377,36 @@ private:
 	/** Auto-incrementing process Id */
 	int pidCounter;
 
-	/** Event list */
-	Common::List<EVENT *> _events;
+	/** Events by their Id */
+	typedef HashMap<uint32, EVENT *> EventMap;
+	EventMap _events;
+
+	/** Events which have to be reset at the end of the current cycle */
+	Array<uint32> _pulsedEvents;
+
+	/** Entry in the wait queue of a process or event */
+	struct WaitEntry {
+		PROCESS *pProcess;
+		uint32 waitSerial;
+	};
+
+	/**
+	 * Blocked processes waiting for a process or event, by its Id. Entries
+	 * of processes which were woken up in the meantime are skipped.
+	 */
+	typedef HashMap<uint32, Array<WaitEntry> > WaitQueueMap;
+	WaitQueueMap _waitQueues;
+
+	enum {
+		kTimerWheelSlots = 64,
+		kTimerWheelShift = 4    ///< each slot covers 16 milliseconds
+	};
+
+	/** Blocked processes with a wake-up time, hashed by that time */
+	PROCESS *_timerWheel[kTimerWheelSlots];
+
+	/** Time up to which the timer wheel has been processed */
+	uint32 _timerWheelTime;
 
 #ifdef DEBUG
 	// diagnostic process counters
@@ -380,6 +428,18 @@ private:
 
 	PROCESS *getProcess(uint32 pid);
 	EVENT *getEvent(uint32 pid);
+
+	/**
+	 * Stops running the current process until one of the given processes or
+	 * events changes, or the given time is reached. Waking up a process does
+	 * not mean that its wait is over; it still has to check that itself.
+	 */
+	void blockCurrentProcess(const uint32 *pidList, int nCount, uint32 wakeTime);
+	void wakeProcess(PROCESS *pProc);
+	void wakeWaitingProcesses(uint32 pid);
+	void addTimer(PROCESS *pProc);
+	void removeTimer(PROCESS *pProc);
+	void processTimers(uint32 time);
 public:
 	/**
 	 * Kills all processes and places them on the free list.
@@ -490,6 +550,17 @@ public:
 	 */
 	int getCurrentPID() const;
 
+	/**
+	 * Returns a table of the active processes with their timing counters,
+	 * one line per process, to be shown in a debugger.
+	 */
+	String getProcessStats() const;
+
+	/**
+	 * Resets the timing counters of all active processes.
+	 */
+	void resetProcessStats();
+
 	/**
 	 * Kills any process matching the specified PID. The current
 	 * process cannot be killed.
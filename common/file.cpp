@@ -24,6 +24,7 @@
 #include "common/debug.h"
 #include "common/file.h"
 #include "common/fs.h"
+#include "common/profiler.h"
 #include "common/textconsole.h"
 
 namespace Common {
@@ -44,6 +45,7 @@ bool File::open(const String &filename, Archive &archive) {
 	assert(!filename.empty());
 	assert(!_handle);
 
+	ProfileScope profile(kProfileResource);
 	SeekableReadStream *stream = 0;
 
 	if ((stream = archive.createReadStreamForMember(filename))) {
@@ -60,6 +62,8 @@ bool File::open(const String &filename, Archive &archive) {
 bool File::open(const FSNode &node) {
 	assert(!_handle);
 
+	ProfileScope profile(kProfileResource);
+
 	if (!node.exists()) {
 		warning("File::open: '%s' does not exist", node.getPath().c_str());
 		return false;
@@ -133,11 +137,13 @@ int32 File::size() const {
 
 bool File::seek(int32 offs, int whence) {
 	assert(_handle);
+	ProfileScope profile(kProfileResource);
 	return _handle->seek(offs, whence);
 }
 
 uint32 File::read(void *ptr, uint32 len) {
 	assert(_handle);
+	ProfileScope profile(kProfileResource);
 	return _handle->read(ptr, len);
 }
 
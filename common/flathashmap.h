@@ -0,0 +1,513 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_FLATHASHMAP_H
+#define COMMON_FLATHASHMAP_H
+
+#include "common/func.h"
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> maps objects of type Key to objects of type Val, with
+ * the same interface as HashMap.
+ *
+ * Unlike HashMap, the entries are stored inline in a single array, which is
+ * probed linearly, instead of being allocated one by one. Next to that
+ * array, one control byte per slot records whether the slot is empty,
+ * deleted or in use, together with 7 bits of the hash of its key. Lookups
+ * scan the control bytes and only compare keys when those bits match, so
+ * most probes never touch the entries themselves.
+ *
+ * This makes lookups considerably faster for small keys and values, at the
+ * cost of moving entries whenever the map grows.
+ *
+ * @note Unlike HashMap, whose entries are allocated one by one and never
+ * move, inserting a new key may move all entries. References and pointers
+ * to keys and values, as well as iterators, are invalidated by it. Code
+ * like "Val &v = map[a]; map[b] = x; v = y;" works with HashMap but not with
+ * FlatHashMap, so check for this before switching a map over. Erasing an
+ * entry leaves the other entries where they are.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+		Node(const Key &key, const Val &value) : _key(key), _value(value) {}
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The map is rehashed once used and deleted slots take up more
+		// than this fraction of the storage.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 3,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 4
+	};
+
+	enum {
+		kCtrlEmpty = 0x80,
+		kCtrlDeleted = 0xFE
+		// Slots in use store the upper 7 bits of the hash, 0x00 - 0x7F
+	};
+
+	byte *_ctrl;		///< Control byte of each slot
+	Node *_slots;		///< Storage for the entries, only slots in use are constructed
+	size_type _mask;	///< Capacity of the map minus one; capacity is a power of two
+	uint _shift;		///< 32 minus the binary logarithm of the capacity
+	size_type _size;
+	size_type _deleted;	///< Number of slots marked as deleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+	static bool isFull(byte ctrl) { return !(ctrl & 0x80); }
+
+	/**
+	 * Scramble the hash by Fibonacci hashing. The slot index is taken from
+	 * the upper bits of the result, which spreads even consecutive keys
+	 * (with the trivial hash function for ints) evenly across the map and
+	 * keeps the probe sequences short. The control bits are taken from the
+	 * lower bits, which differ between keys landing close to each other.
+	 */
+	static uint32 mixHash(uint hash) { return (uint32)hash * 0x9E3779B1U; }
+	static byte ctrlForHash(uint32 mixed) { return (byte)(mixed & 0x7F); }
+	size_type slotForHash(uint32 mixed) const { return mixed >> _shift; }
+
+	void allocStorage(size_type capacity);
+	void destroyAll();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+	void eraseSlot(size_type idx);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != 0);
+			assert(_idx <= _hashmap->_mask);
+			assert(isFull(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(0) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isFull(_hashmap->_ctrl[_idx]));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		destroyAll();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first non-empty entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isFull(_ctrl[ctr]))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (isFull(_ctrl[ctr]))
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (isFull(_ctrl[ctr]))
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	destroyAll();
+}
+
+/**
+ * Internal method for allocating empty storage of the given capacity.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	_mask = capacity - 1;
+	_shift = 32;
+	while (capacity > 1) {
+		capacity >>= 1;
+		_shift--;
+	}
+	capacity = _mask + 1;
+	_ctrl = new byte[capacity];
+	memset(_ctrl, kCtrlEmpty, capacity);
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	assert(_slots != NULL);
+
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for destroying all entries and freeing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::destroyAll() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			_slots[ctr].~Node();
+	}
+
+	delete[] _ctrl;
+	free(_slots);
+	_ctrl = 0;
+	_slots = 0;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// Simply clone the map given to us, slot by slot.
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isFull(_ctrl[ctr]))
+			_slots[ctr].~Node();
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		delete[] _ctrl;
+		free(_slots);
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, kCtrlEmpty, _mask + 1);
+		_size = 0;
+		_deleted = 0;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	assert(newCapacity > _size);
+
+	byte *oldCtrl = _ctrl;
+	Node *oldSlots = _slots;
+	const size_type oldMask = _mask;
+
+	allocStorage(newCapacity);
+
+	// Move all entries into the new storage. There are no deleted slots
+	// and no duplicate keys yet, so we can simply take the first free slot.
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!isFull(oldCtrl[ctr]))
+			continue;
+
+		const uint32 mixed = mixHash(_hash(oldSlots[ctr]._key));
+		size_type idx = slotForHash(mixed);
+		while (_ctrl[idx] != kCtrlEmpty)
+			idx = (idx + 1) & _mask;
+
+		_ctrl[idx] = ctrlForHash(mixed);
+		new ((void *)&_slots[idx]) Node(oldSlots[ctr]);
+		oldSlots[ctr].~Node();
+		_size++;
+	}
+
+	delete[] oldCtrl;
+	free(oldSlots);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const uint32 mixed = mixHash(_hash(key));
+	const byte ctrl = ctrlForHash(mixed);
+
+	// The load factor guarantees that there is always an empty slot, so
+	// this loop terminates. The empty slot is returned if key is missing.
+	size_type idx = slotForHash(mixed);
+	for (;;) {
+		const byte c = _ctrl[idx];
+		if (c == kCtrlEmpty)
+			return idx;
+		if (c == ctrl && _equal(_slots[idx]._key, key))
+			return idx;
+		idx = (idx + 1) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type idx = lookup(key);
+	if (isFull(_ctrl[idx]))
+		return idx;
+
+	// Make room if used and deleted slots would exceed the load factor.
+	// Grow the storage if it is actually needed, otherwise rehashing at the
+	// same size gets rid of the deleted slots.
+	const size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		size_type newCapacity = capacity;
+		if ((_size + 1) * 2 * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+			newCapacity = capacity < 500 ? capacity * 4 : capacity * 2;
+		rehash(newCapacity);
+	}
+
+	// Insert into the first deleted or empty slot along the probe sequence
+	const uint32 mixed = mixHash(_hash(key));
+	idx = slotForHash(mixed);
+	while (isFull(_ctrl[idx]))
+		idx = (idx + 1) & _mask;
+
+	if (_ctrl[idx] == kCtrlDeleted)
+		_deleted--;
+	_ctrl[idx] = ctrlForHash(mixed);
+	new ((void *)&_slots[idx]) Node(key);
+	_size++;
+
+	return idx;
+}
+
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	size_type ctr = lookup(key);
+	return isFull(_ctrl[ctr]);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr]))
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::eraseSlot(size_type idx) {
+	_slots[idx].~Node();
+	_size--;
+
+	// With linear probing, a slot followed by an empty one is not part of
+	// any probe sequence passing it, so it can become empty right away.
+	if (_ctrl[(idx + 1) & _mask] == kCtrlEmpty) {
+		_ctrl[idx] = kCtrlEmpty;
+	} else {
+		_ctrl[idx] = kCtrlDeleted;
+		_deleted++;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isFull(_ctrl[ctr]));
+
+	eraseSlot(ctr);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (isFull(_ctrl[ctr]))
+		eraseSlot(ctr);
+}
+
+} // End of namespace Common
+
+#endif
@@ -34,6 +34,7 @@ class AbstractFSNode;
 namespace Common {
 
 class FSNode;
+class MemoryReadStream;
 class SeekableReadStream;
 class WriteStream;
 
@@ -205,6 +206,24 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Returns the time the object referred by this node was last modified.
+	 * The value is only meant to be compared with earlier results for the
+	 * same node, it is not suitable for displaying.
+	 *
+	 * @return the modification time, or 0 if it is unknown or not supported
+	 *         by the backend
+	 */
+	uint32 getModificationTime() const;
+
+	/**
+	 * Returns the size of the file referred by this node, without opening it.
+	 *
+	 * @return the size in bytes, or -1 if it is unknown or not supported by
+	 *         the backend
+	 */
+	int32 getFileSize() const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -214,6 +233,18 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a MemoryReadStream instance over a read-only memory mapping of
+	 * the file referred by this node, if the backend supports this. The data
+	 * can then be accessed in place through MemoryReadStream::getData(),
+	 * and is only loaded from disk as it is accessed.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure or if
+	 *         the backend does not support memory mapping, in which case
+	 *         createReadStream() can be used instead
+	 */
+	MemoryReadStream *createMappedReadStream() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -330,6 +361,8 @@ public:
 	 */
 	virtual int listMembers(ArchiveMemberList &list) const;
 
+	virtual bool listsAllMembers() const { return true; }
+
 	/**
 	 * Get a ArchiveMember representation of the specified file. A full match of relative
 	 * path and filename is needed for success.
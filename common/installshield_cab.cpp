@@ -60,6 +60,7 @@ public:
 	// Archive API implementation
 	bool hasFile(const String &name) const;
 	int listMembers(ArchiveMemberList &list) const;
+	bool listsAllMembers() const { return true; }
 	const ArchiveMemberPtr getMember(const String &name) const;
 	SeekableReadStream *createReadStreamForMember(const String &name) const;
 
@@ -70,6 +70,12 @@ public:
 	int32 size() const { return _size; }
 
 	bool seek(int32 offs, int whence = SEEK_SET);
+
+	/**
+	 * Return the memory block this stream reads from, which allows parsing
+	 * its data in place instead of reading it into another buffer.
+	 */
+	const byte *getData() const { return _ptrOrig; }
 };
 
 
@@ -135,7 +141,9 @@ private:
 
 		byte *old_data = _data;
 
-		_capacity = new_len + 32;
+		// Grow geometrically, so that many small writes (e.g. when
+		// serializing a savegame) do not copy the data over and over.
+		_capacity = (new_len + 32 > _capacity * 2) ? new_len + 32 : _capacity * 2;
 		_data = (byte *)malloc(_capacity);
 		_ptr = _data + _pos;
 
@@ -0,0 +1,117 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/profiler.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(Profiler);
+
+bool Profiler::_active = false;
+
+Profiler::Profiler() : _clock(0), _startTime(0), _lastTime(0), _depth(0), _overflow(0) {
+	for (int i = 0; i < kProfileSectionCount; ++i) {
+		_time[i] = 0;
+		_calls[i] = 0;
+	}
+}
+
+void Profiler::start(ClockProc clock) {
+	assert(clock);
+
+	_clock = clock;
+	for (int i = 0; i < kProfileSectionCount; ++i) {
+		_time[i] = 0;
+		_calls[i] = 0;
+	}
+
+	_stack[0] = kProfileEngine;
+	_depth = 1;
+	_overflow = 0;
+
+	_startTime = _lastTime = _clock();
+	_active = true;
+}
+
+void Profiler::stop() {
+	if (!_active)
+		return;
+
+	charge(_clock());
+	_active = false;
+}
+
+void Profiler::charge(uint64 now) {
+	_time[_stack[_depth - 1]] += now - _lastTime;
+	_lastTime = now;
+}
+
+void Profiler::enter(ProfileSection section) {
+	if (!_active)
+		return;
+
+	_calls[section]++;
+
+	if (_depth == kMaxDepth) {
+		++_overflow;
+		return;
+	}
+
+	charge(_clock());
+	_stack[_depth++] = section;
+}
+
+void Profiler::leave() {
+	if (!_active)
+		return;
+
+	if (_overflow) {
+		--_overflow;
+		return;
+	}
+
+	// The section at the bottom of the stack stays there, this keeps
+	// scopes entered before start() was called from unbalancing it.
+	if (_depth > 1) {
+		charge(_clock());
+		--_depth;
+	}
+}
+
+uint64 Profiler::getTotalTime() const {
+	return (_active ? _clock() : _lastTime) - _startTime;
+}
+
+const char *Profiler::getSectionName(ProfileSection section) {
+	static const char *const names[kProfileSectionCount] = {
+		"engine",
+		"script",
+		"graphics",
+		"updateScreen",
+		"audio",
+		"resource"
+	};
+
+	return names[section];
+}
+
+} // End of namespace Common
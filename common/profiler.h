@@ -0,0 +1,129 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_PROFILER_H
+#define COMMON_PROFILER_H
+
+#include "common/scummsys.h"
+#include "common/noncopyable.h"
+#include "common/singleton.h"
+
+namespace Common {
+
+/** Subsystems the profiler accounts time to. */
+enum ProfileSection {
+	kProfileEngine = 0,		///< Everything not covered by another section
+	kProfileScript,			///< Script interpreters
+	kProfileGraphics,		///< Engine side drawing and backend screen calls
+	kProfileScreenUpdate,	///< OSystem::updateScreen
+	kProfileAudio,			///< Mixing audio output
+	kProfileResource,		///< Opening and reading game files
+	kProfileSectionCount
+};
+
+/**
+ * Simple profiler which splits the run time of the program between a fixed
+ * set of subsystems.
+ *
+ * Sections may be nested, the time spent in an inner section is only
+ * accounted to that section. The profiler is not thread safe and is meant
+ * for benchmark runs where everything happens on a single thread, like
+ * replaying a recorded session with the null backend.
+ *
+ * The clock is provided by the backend enabling the profiler, since OSystem
+ * only offers a millisecond timer which might not even be real time.
+ */
+class Profiler : public Singleton<Profiler> {
+public:
+	/** Clock used by the profiler, returning microseconds. */
+	typedef uint64 (*ClockProc)();
+
+	/** Reset all counters and start profiling. */
+	void start(ClockProc clock);
+
+	/** Stop profiling, keeping the counters. */
+	void stop();
+
+	static bool isActive() { return _active; }
+
+	void enter(ProfileSection section);
+	void leave();
+
+	/** Return the time spent in the given section, in microseconds. */
+	uint64 getTime(ProfileSection section) const { return _time[section]; }
+
+	/** Return how often the given section was entered. */
+	uint32 getCalls(ProfileSection section) const { return _calls[section]; }
+
+	/** Return the total time since start() was called, in microseconds. */
+	uint64 getTotalTime() const;
+
+	static const char *getSectionName(ProfileSection section);
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	Profiler();
+
+	void charge(uint64 now);
+
+	enum {
+		kMaxDepth = 32
+	};
+
+	static bool _active;
+
+	ClockProc _clock;
+	uint64 _startTime;
+	uint64 _lastTime;
+
+	ProfileSection _stack[kMaxDepth];
+	int _depth;
+	/** Number of leave() calls to ignore, for sections nested too deep */
+	int _overflow;
+
+	uint64 _time[kProfileSectionCount];
+	uint32 _calls[kProfileSectionCount];
+};
+
+/**
+ * Accounts the lifetime of the object to the given section, if the
+ * profiler is active.
+ */
+class ProfileScope : NonCopyable {
+public:
+	ProfileScope(ProfileSection section) : _active(Profiler::isActive()) {
+		if (_active)
+			Profiler::instance().enter(section);
+	}
+
+	~ProfileScope() {
+		if (_active)
+			Profiler::instance().leave();
+	}
+
+private:
+	const bool _active;
+};
+
+} // End of namespace Common
+
+#endif
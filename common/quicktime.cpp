@@ -28,6 +28,7 @@
 // Seek function by Gael Chardon gael.dev@4now.net
 //
 
+#include "common/bufferedstream.h"
 #include "common/debug.h"
 #include "common/endian.h"
 #include "common/macresman.h"
@@ -39,6 +40,12 @@
 
 namespace Common {
 
+enum {
+	// Atoms and sample tables are read in many small pieces, and the
+	// chunks of the tracks are interleaved, so we buffer the stream.
+	kReadBufferSize = 4096
+};
+
 ////////////////////////////////////////////
 // QuickTimeParser
 ////////////////////////////////////////////
@@ -84,7 +91,7 @@ bool QuickTimeParser::parseFile(const String &filename) {
 		delete _fd;
 	}
 
-	_fd = _resFork->getDataFork();
+	_fd = wrapBufferedSeekableReadStream(_resFork->getDataFork(), kReadBufferSize, DisposeAfterUse::YES);
 	atom.size = _fd->size();
 
 	if (readDefault(atom) < 0 || !_foundMOOV)
@@ -95,9 +102,9 @@ bool QuickTimeParser::parseFile(const String &filename) {
 }
 
 bool QuickTimeParser::parseStream(SeekableReadStream *stream, DisposeAfterUse::Flag disposeFileHandle) {
-	_fd = stream;
+	_fd = wrapBufferedSeekableReadStream(stream, kReadBufferSize, disposeFileHandle);
 	_foundMOOV = false;
-	_disposeFileHandle = disposeFileHandle;
+	_disposeFileHandle = DisposeAfterUse::YES;
 
 	Atom atom = { 0, 0, 0xffffffff };
 
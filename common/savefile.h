@@ -122,6 +122,34 @@ public:
 	 */
 	virtual OutSaveFile *openForSaving(const String &name, bool compress = true) = 0;
 
+	/**
+	 * Open the savefile with the specified name in the given directory for
+	 * saving in the background.
+	 *
+	 * Data written to the returned savefile is kept in memory. Finalizing or
+	 * deleting the savefile hands it over to a background task, which
+	 * compresses it and writes it to the file, so the caller does not have
+	 * to wait for that. Errors which occur in the background can not be
+	 * reported to the caller anymore; they are only logged. Hence this is
+	 * meant for saves like autosaves, where the game continues immediately.
+	 *
+	 * The default implementation simply calls openForSaving().
+	 *
+	 * @param name		the name of the savefile
+	 * @param compress	toggles whether to compress the resulting save file
+	 * 					(default) or not.
+	 * @return pointer to an OutSaveFile, or NULL if an error occurred.
+	 */
+	virtual OutSaveFile *openForSavingInBackground(const String &name, bool compress = true) { return openForSaving(name, compress); }
+
+	/**
+	 * Write all savefiles saved in the background, and release everything
+	 * used for saving in the background. Engines using
+	 * openForSavingInBackground() call this when they are destroyed, while
+	 * the backend is still fully available.
+	 */
+	virtual void finishBackgroundSaves() {}
+
 	/**
 	 * Open the file with the specified name in the given directory for loading.
 	 * @param name	the name of the savefile
@@ -161,6 +189,15 @@ public:
 	 * @see Common::matchString()
 	 */
 	virtual StringArray listSavefiles(const String &pattern) = 0;
+
+	/**
+	 * Return a number which changes whenever a savefile is written or
+	 * removed through this manager. This allows caching information read
+	 * from savefiles.
+	 *
+	 * @return the current revision, or 0 if changes are not tracked.
+	 */
+	virtual uint32 getRevision() const { return 0; }
 };
 
 } // End of namespace Common
@@ -20,11 +20,13 @@
  *
  */
 
+#include "common/bufferedstream.h"
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/memstream.h"
 #include "common/substream.h"
 #include "common/str.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -250,6 +252,12 @@ uint32 SafeSeekableSubReadStream::read(void *dataPtr, uint32 dataSize) {
 
 #pragma mark -
 
+static BufferedReadStats g_bufferedReadStats = { 0, 0 };
+
+const BufferedReadStats &getBufferedReadStats() {
+	return g_bufferedReadStats;
+}
+
 namespace {
 
 /**
@@ -316,6 +324,8 @@ uint32 BufferedReadStream::read(void *dataPtr, uint32 dataSize) {
 			uint32 n = _parentStream->read(dataPtr, dataSize);
 			if (_parentStream->eos())
 				_eos = true;
+			g_bufferedReadStats.bytesFetched += n;
+			g_bufferedReadStats.bytesDelivered += alreadyRead + n;
 			return alreadyRead + n;
 		}
 
@@ -326,6 +336,7 @@ uint32 BufferedReadStream::read(void *dataPtr, uint32 dataSize) {
 		// return to the caller.
 		_bufSize = _parentStream->read(_buf, _realBufSize);
 		_pos = 0;
+		g_bufferedReadStats.bytesFetched += _bufSize;
 		if (_bufSize < dataSize) {
 			// we didn't get enough data from parent
 			if (_parentStream->eos())
@@ -339,6 +350,7 @@ uint32 BufferedReadStream::read(void *dataPtr, uint32 dataSize) {
 		memcpy(dataPtr, _buf + _pos, dataSize);
 		_pos += dataSize;
 	}
+	g_bufferedReadStats.bytesDelivered += alreadyRead + dataSize;
 	return alreadyRead + dataSize;
 }
 
@@ -357,66 +369,220 @@ namespace {
 
 /**
  * Wrapper class which adds buffering to any given SeekableReadStream.
+ *
+ * Data is buffered in a few blocks, so that client code jumping back and
+ * forth, e.g. between the chunks of a container format, finds the data
+ * it returns to in one of them. Blocks for random accesses are aligned to
+ * the requested buffer size and replaced in least recently used order.
+ * While the stream is read sequentially, a single block is reused and
+ * grows with every refill, up to a limit.
+ *
  * @see BufferedReadStream
  */
-class BufferedSeekableReadStream : public BufferedReadStream, public SeekableReadStream {
+class BufferedSeekableReadStream : public SeekableReadStream {
 protected:
-	SeekableReadStream *_parentStream;
+	enum {
+		kBlockCount = 4,
+		/** Sequential reads grow the blocks up to this factor... */
+		kMaxGrowth = 8,
+		/** ...but not beyond this size, unless requested explicitly */
+		kMaxGrowthSize = 256 * 1024
+	};
+
+	struct Block {
+		byte *data;
+		uint32 capacity;
+		int32 start;
+		uint32 size;
+		uint32 lastUse;
+	};
+
+	DisposablePtr<SeekableReadStream> _parentStream;
+	Block _blocks[kBlockCount];
+	/** Block which satisfied the last read, checked first */
+	Block *_current;
+	int32 _pos;
+	/** Position of the parent stream, to avoid needless seeks */
+	int32 _parentPos;
+	/** Position where the last refill ended */
+	int32 _sequentialPos;
+	uint32 _blockSize;
+	uint32 _maxFillSize;
+	uint32 _fillSize;
+	uint32 _useCounter;
+	bool _eos;
+
+	Block *findBlock(int32 pos);
+	Block *fillBlock(int32 pos);
+	uint32 readParent(int32 pos, void *dataPtr, uint32 dataSize);
+
 public:
 	BufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream = DisposeAfterUse::NO);
+	virtual ~BufferedSeekableReadStream();
 
-	virtual int32 pos() const { return _parentStream->pos() - (_bufSize - _pos); }
+	virtual bool eos() const { return _eos; }
+	virtual bool err() const { return _parentStream->err(); }
+	virtual void clearErr() { _eos = false; _parentStream->clearErr(); }
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual int32 pos() const { return _pos; }
 	virtual int32 size() const { return _parentStream->size(); }
 
 	virtual bool seek(int32 offset, int whence = SEEK_SET);
 };
 
 BufferedSeekableReadStream::BufferedSeekableReadStream(SeekableReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream)
-	: BufferedReadStream(parentStream, bufSize, disposeParentStream),
-	_parentStream(parentStream) {
+	: _parentStream(parentStream, disposeParentStream),
+	_current(0),
+	_blockSize(MAX<uint32>(bufSize, 1)),
+	_useCounter(0),
+	_eos(false) {
+
+	assert(parentStream);
+	memset(_blocks, 0, sizeof(_blocks));
+
+	_pos = _parentPos = _sequentialPos = parentStream->pos();
+	_fillSize = _blockSize;
+	_maxFillSize = MAX<uint32>(_blockSize, MIN<uint32>(_blockSize * kMaxGrowth, kMaxGrowthSize));
+}
+
+BufferedSeekableReadStream::~BufferedSeekableReadStream() {
+	for (int i = 0; i < kBlockCount; ++i)
+		delete[] _blocks[i].data;
+}
+
+uint32 BufferedSeekableReadStream::readParent(int32 pos, void *dataPtr, uint32 dataSize) {
+	if (_parentPos != pos) {
+		_parentStream->seek(pos, SEEK_SET);
+		_parentPos = pos;
+	}
+
+	const uint32 n = _parentStream->read(dataPtr, dataSize);
+	_parentPos += n;
+	_sequentialPos = _parentPos;
+	g_bufferedReadStats.bytesFetched += n;
+	return n;
+}
+
+BufferedSeekableReadStream::Block *BufferedSeekableReadStream::findBlock(int32 pos) {
+	if (_current && pos >= _current->start && pos < _current->start + (int32)_current->size) {
+		_current->lastUse = ++_useCounter;
+		return _current;
+	}
+
+	for (int i = 0; i < kBlockCount; ++i) {
+		Block &block = _blocks[i];
+		if (block.data && pos >= block.start && pos < block.start + (int32)block.size) {
+			block.lastUse = ++_useCounter;
+			return &block;
+		}
+	}
+
+	return 0;
+}
+
+BufferedSeekableReadStream::Block *BufferedSeekableReadStream::fillBlock(int32 pos) {
+	Block *block;
+	int32 start;
+
+	if (pos == _sequentialPos && _current) {
+		// Sequential access: Reuse the block we just finished and read a
+		// larger amount of data, as more will most likely follow.
+		block = _current;
+		start = pos;
+		_fillSize = MIN(_fillSize * 2, _maxFillSize);
+	} else {
+		// Random access: Read the aligned block containing pos into the
+		// least recently used block.
+		block = &_blocks[0];
+		for (int i = 1; i < kBlockCount && block->data; ++i) {
+			if (!_blocks[i].data || _blocks[i].lastUse < block->lastUse)
+				block = &_blocks[i];
+		}
+		start = pos - pos % _blockSize;
+		_fillSize = _blockSize;
+	}
+
+	const uint32 fillSize = MAX<uint32>(_fillSize, pos - start + 1);
+	if (block->capacity < fillSize) {
+		delete[] block->data;
+		block->data = new byte[fillSize];
+		block->capacity = fillSize;
+	}
+
+	block->start = start;
+	block->size = readParent(start, block->data, fillSize);
+	block->lastUse = ++_useCounter;
+
+	_current = block;
+	if (pos >= block->start + (int32)block->size)
+		return 0;
+	return block;
+}
+
+uint32 BufferedSeekableReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 alreadyRead = 0;
+
+	while (dataSize > 0) {
+		Block *block = findBlock(_pos);
+
+		if (!block) {
+			// Requests larger than a block are satisfied directly
+			if (dataSize >= _maxFillSize) {
+				const uint32 n = readParent(_pos, dst, dataSize);
+				_pos += n;
+				alreadyRead += n;
+				dataSize -= n;
+				break;
+			}
+
+			block = fillBlock(_pos);
+			if (!block)
+				break;
+		}
+
+		_current = block;
+
+		const uint32 offset = _pos - block->start;
+		const uint32 n = MIN(dataSize, block->size - offset);
+		memcpy(dst, block->data + offset, n);
+		_pos += n;
+		dst += n;
+		alreadyRead += n;
+		dataSize -= n;
+	}
+
+	// We could not satisfy the request, due to EOF or an error
+	if (dataSize > 0)
+		_eos = true;
+
+	g_bufferedReadStats.bytesDelivered += alreadyRead;
+	return alreadyRead;
 }
 
 bool BufferedSeekableReadStream::seek(int32 offset, int whence) {
-	// If it is a "local" seek, we may get away with "seeking" around
-	// in the buffer only.
 	_eos = false;	// seeking always cancels EOS
 
-	int relOffset = 0;
 	switch (whence) {
 	case SEEK_SET:
-		relOffset = offset - pos();
 		break;
 	case SEEK_CUR:
-		relOffset = offset;
+		offset += _pos;
 		break;
 	case SEEK_END:
-		relOffset = (size() + offset) - pos();
+		offset += size();
 		break;
 	default:
 		break;
 	}
 
-	if ((int)_pos + relOffset >= 0 && _pos + relOffset <= _bufSize) {
-		_pos += relOffset;
-
-		// Note: we do not need to reset parent's eos flag here. It is
-		// sufficient that it is reset when actually seeking in the parent.
-	} else {
-		// Seek was not local enough, so we reset the buffer and
-		// just seek normally in the parent stream.
-		if (whence == SEEK_CUR)
-			offset -= (_bufSize - _pos);
-		// We invalidate the buffer here. This assures that successive seeks
-		// do not have the chance to incorrectly think they seeked back into
-		// the buffer.
-		// Note: This does not take full advantage of the buffer. But it is
-		// a simple way to prevent nasty errors. It would be possible to take
-		// full advantage of the buffer by saving its actual start position.
-		// This seems not worth the effort for this seemingly uncommon use.
-		_pos = _bufSize = 0;
-		_parentStream->seek(offset, whence);
-	}
+	if (offset < 0)
+		return false;
 
+	// The parent stream is only repositioned when data is read from it.
+	_pos = offset;
 	return true;
 }
 
@@ -703,6 +703,7 @@ public:
 	// Archive implementation
 	virtual bool hasFile(const String &name) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
+	virtual bool listsAllMembers() const { return true; }
 	virtual const ArchiveMemberPtr getMember(const String &name) const;
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 };
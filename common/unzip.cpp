@@ -102,9 +102,12 @@ typedef struct {
 
 #endif  // !USE_ZLIB
 
+#include "common/bufferedstream.h"
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/zlib.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -631,6 +634,8 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
   Close a ZipFile opened with unzipOpen.
   If there is files inside the .Zip opened with unzipOpenCurrentFile (see later),
     these files MUST be closed with unzipCloseCurrentFile before call unzipClose.
+  The stream passed to unzOpen is not deleted, as streams of members may still
+    be reading from it.
   return UNZ_OK if there is no problem. */
 int unzClose(unzFile file) {
 	unz_s *s;
@@ -641,7 +646,6 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
 	delete s;
 	return UNZ_OK;
 }
@@ -1417,8 +1421,129 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 namespace Common {
 
 
+/**
+ * The stream of a ZIP archive. It is shared by the archive and the streams of
+ * its members, which read from it on demand. These may outlive the archive,
+ * and may be read from other threads, e.g. by the mixer, so all accesses and
+ * the reference count are protected by a mutex.
+ */
+class ZipArchiveStream {
+	SeekableReadStream *_stream;
+	Mutex _mutex;
+	int _refCount;
+
+	~ZipArchiveStream() {
+		delete _stream;
+	}
+
+public:
+	ZipArchiveStream(SeekableReadStream *stream) : _stream(stream), _refCount(1) {
+		assert(_stream);
+	}
+
+	/** Lock this while accessing the stream through the unz functions. */
+	Mutex &getMutex() { return _mutex; }
+
+	void incRef() {
+		StackLock lock(_mutex);
+		++_refCount;
+	}
+
+	void decRef() {
+		bool unused;
+		{
+			StackLock lock(_mutex);
+			unused = (--_refCount == 0);
+		}
+		if (unused)
+			delete this;
+	}
+
+	uint32 read(uint32 position, void *dataPtr, uint32 dataSize) {
+		StackLock lock(_mutex);
+		if (!_stream->seek(position, SEEK_SET))
+			return 0;
+		return _stream->read(dataPtr, dataSize);
+	}
+};
+
+/**
+ * Read stream for the data of an archive member as stored in the archive,
+ * which is read from the archive stream on demand instead of being copied.
+ * Several of these can be used at the same time.
+ */
+class ZipMemberStream : public SeekableReadStream {
+	ZipArchiveStream *_archive;
+	const uint32 _begin;
+	const uint32 _size;
+	uint32 _pos;
+	bool _eos;
+	bool _err;
+
+public:
+	ZipMemberStream(ZipArchiveStream *archive, uint32 begin, uint32 size)
+		: _archive(archive), _begin(begin), _size(size), _pos(0), _eos(false), _err(false) {
+		_archive->incRef();
+	}
+
+	~ZipMemberStream() {
+		_archive->decRef();
+	}
+
+	bool err() const { return _err; }
+	void clearErr() { _eos = false; _err = false; }
+	bool eos() const { return _eos; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
+
+		const uint32 bytesRead = _archive->read(_begin + _pos, dataPtr, dataSize);
+		if (bytesRead != dataSize)
+			_err = true;
+		_pos += bytesRead;
+
+		return bytesRead;
+	}
+
+	int32 pos() const { return _pos; }
+	int32 size() const { return _size; }
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		switch (whence) {
+		case SEEK_END:
+			offset = _size + offset;
+			break;
+		case SEEK_CUR:
+			offset = _pos + offset;
+			break;
+		}
+
+		if (offset < 0 || (uint32)offset > _size)
+			return false;
+
+		_pos = offset;
+		_eos = false;
+		return true;
+	}
+};
+
 class ZipArchive : public Archive {
 	unzFile _zipFile;
+	ZipArchiveStream *_stream;
+
+	enum {
+		/**
+		 * Compressed members up to this size are decompressed into memory
+		 * at once, larger ones are decompressed while being read. Seeking
+		 * backwards in the latter restarts the decompression.
+		 */
+		kMaxInflatedMemberSize = 256 * 1024,
+		/** Size of the read buffer of stored members */
+		kStoredBufferSize = 4096
+	};
 
 public:
 	ZipArchive(unzFile zipFile);
@@ -1428,6 +1553,7 @@ public:
 
 	virtual bool hasFile(const String &name) const;
 	virtual int listMembers(ArchiveMemberList &list) const;
+	virtual bool listsAllMembers() const { return true; }
 	virtual const ArchiveMemberPtr getMember(const String &name) const;
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 };
@@ -1452,10 +1578,12 @@ public:
 
 ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
 	assert(_zipFile);
+	_stream = new ZipArchiveStream(((unz_s *)_zipFile)->_stream);
 }
 
 ZipArchive::~ZipArchive() {
 	unzClose(_zipFile);
+	_stream->decRef();
 }
 
 bool ZipArchive::hasFile(const String &name) const {
@@ -1483,6 +1611,9 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	// Streams of other members may be reading from the archive right now
+	StackLock lock(_stream->getMutex());
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
@@ -1493,6 +1624,25 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
 		return 0;
 
+	// Stored members, and large compressed ones, are read from the archive
+	// on demand instead of being loaded into memory.
+	const bool stored = (fileInfo.compression_method == 0);
+	if (stored || fileInfo.uncompressed_size > kMaxInflatedMemberSize) {
+		const unz_s *archive = (const unz_s *)_zipFile;
+		const uint32 begin = archive->pfile_in_zip_read->pos_in_zipfile + archive->byte_before_the_zipfile;
+		unzCloseCurrentFile(_zipFile);
+
+		SeekableReadStream *member = new ZipMemberStream(_stream, begin, fileInfo.compressed_size);
+		if (stored) {
+			// Every read from the archive locks it and seeks, so callers
+			// reading a few bytes at a time need a buffer. Compressed
+			// members are buffered by the decompressor.
+			return wrapBufferedSeekableReadStream(member, kStoredBufferSize, DisposeAfterUse::YES);
+		}
+
+		return wrapDeflateReadStream(member, fileInfo.uncompressed_size);
+	}
+
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
 	assert(buffer);
 
@@ -1507,11 +1657,6 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -1519,7 +1664,12 @@ Archive *makeZipArchive(const String &name) {
 }
 
 Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
+	// Members of a mapped archive are read without any file accesses, and
+	// only the parts of the archive which are used are loaded from disk.
+	SeekableReadStream *stream = node.createMappedReadStream();
+	if (!stream)
+		stream = node.createReadStream();
+	return makeZipArchive(stream);
 }
 
 Archive *makeZipArchive(SeekableReadStream *stream) {
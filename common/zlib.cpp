@@ -142,7 +142,8 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
- * Assumes the compressed data to be in gzip format.
+ * Assumes the compressed data to be in gzip or zlib format, or to be raw deflate
+ * data if headerless is set.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
@@ -158,37 +159,48 @@ protected:
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
+	bool _headerless;
 
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0, bool headerless = false) : _wrapped(w), _stream(), _headerless(headerless) {
 		assert(w != 0);
 
-		// Verify file header is correct
-		w->seek(0, SEEK_SET);
-		uint16 header = w->readUint16BE();
-		assert(header == 0x1F8B ||
-		       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
-
-		if (header == 0x1F8B) {
-			// Retrieve the original file size
-			w->seek(-4, SEEK_END);
-			_origSize = w->readUint32LE();
-		} else {
-			// Original size not available in zlib format
-			// use an otherwise known size if supplied.
+		if (headerless) {
+			// Raw deflate data does not contain its size
 			_origSize = knownSize;
+		} else {
+			// Verify file header is correct
+			w->seek(0, SEEK_SET);
+			uint16 header = w->readUint16BE();
+			assert(header == 0x1F8B ||
+			       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
+
+			if (header == 0x1F8B) {
+				// Retrieve the original file size
+				w->seek(-4, SEEK_END);
+				_origSize = w->readUint32LE();
+			} else {
+				// Original size not available in zlib format
+				// use an otherwise known size if supplied.
+				_origSize = knownSize;
+			}
 		}
 		_pos = 0;
 		w->seek(0, SEEK_SET);
 		_eos = false;
 
-		// Adding 32 to windowBits indicates to zlib that it is supposed to
-		// automatically detect whether gzip or zlib headers are used for
-		// the compressed file. This feature was added in zlib 1.2.0.4,
-		// released 10 August 2003.
-		// Note: This is *crucial* for savegame compatibility, do *not* remove!
-		_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		if (headerless) {
+			// A negative windowBits value tells zlib that there is no header
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+		} else {
+			// Adding 32 to windowBits indicates to zlib that it is supposed to
+			// automatically detect whether gzip or zlib headers are used for
+			// the compressed file. This feature was added in zlib 1.2.0.4,
+			// released 10 August 2003.
+			// Note: This is *crucial* for savegame compatibility, do *not* remove!
+			_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		}
 		if (_zlibErr != Z_OK)
 			return;
 
@@ -208,6 +220,13 @@ public:
 	}
 
 	uint32 read(void *dataPtr, uint32 dataSize) {
+		// Raw deflate data may be followed by unrelated data, so we rely on
+		// the known size to detect its end.
+		if (_headerless && dataSize > _origSize - _pos) {
+			dataSize = _origSize - _pos;
+			_eos = true;
+		}
+
 		_stream.next_out = (byte *)dataPtr;
 		_stream.avail_out = dataSize;
 
@@ -241,8 +260,11 @@ public:
 	}
 	bool seek(int32 offset, int whence = SEEK_SET) {
 		int32 newPos = 0;
-		assert(whence != SEEK_END);	// SEEK_END not supported
+		assert(whence != SEEK_END || _headerless);	// SEEK_END needs a known size
 		switch (whence) {
+		case SEEK_END:
+			newPos = _origSize + offset;
+			break;
 		case SEEK_SET:
 			newPos = offset;
 			break;
@@ -275,7 +297,10 @@ public:
 		// bytes, so this should be fine.
 		byte tmpBuf[1024];
 		while (!err() && offset > 0) {
-			offset -= read(tmpBuf, MIN((int32)sizeof(tmpBuf), offset));
+			const uint32 skipped = read(tmpBuf, MIN((int32)sizeof(tmpBuf), offset));
+			if (!skipped)
+				break;
+			offset -= skipped;
 		}
 
 		_eos = false;
@@ -410,6 +435,18 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 	return toBeWrapped;
 }
 
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 uncompressedSize) {
+	if (!toBeWrapped)
+		return 0;
+
+#if defined(USE_ZLIB)
+	return new GZipReadStream(toBeWrapped, uncompressedSize, true);
+#else
+	delete toBeWrapped;
+	return NULL;
+#endif
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 #if defined(USE_ZLIB)
 	if (toBeWrapped)
@@ -120,6 +120,22 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
  */
 SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0);
 
+/**
+ * Take an arbitrary SeekableReadStream containing raw deflate data, i.e.
+ * without any gzip or zlib header, as stored in ZIP archives, and wrap it in
+ * a custom stream which provides transparent on-the-fly decompression. As raw
+ * deflate data does not include its length, the size of the decompressed
+ * data must be supplied. If there is no ZLIB support, NULL is returned and
+ * the stream is destroyed.
+ *
+ * It is safe to call this with a NULL parameter (in this case, NULL is
+ * returned).
+ *
+ * @param toBeWrapped		the stream to be wrapped
+ * @param uncompressedSize	the size of the decompressed data
+ */
+SeekableReadStream *wrapDeflateReadStream(SeekableReadStream *toBeWrapped, uint32 uncompressedSize);
+
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which provides
  * transparent on-the-fly compression. The compressed data is written in the
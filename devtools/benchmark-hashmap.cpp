@@ -0,0 +1,107 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Microbenchmark comparing Common::HashMap with Common::FlatHashMap.
+//
+// Usage: benchmark-hashmap [number of entries]
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/flathashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+	kLookupRounds = 2000000
+};
+
+static double elapsed(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/**
+ * Run the same sequence of inserts, successful and failing lookups, and
+ * erases on a map with the given keys, and print the time of each phase.
+ */
+template<class Map, class Key>
+static void benchmark(const char *name, const Key *keys, const Key *missingKeys, uint count) {
+	Map map;
+	uint32 checksum = 0;
+
+	clock_t start = clock();
+	for (uint i = 0; i < count; ++i)
+		map[keys[i]] = i;
+	const double insertTime = elapsed(start);
+
+	start = clock();
+	for (uint i = 0; i < kLookupRounds; ++i)
+		checksum += map.getVal(keys[(i * 7919) % count]);
+	const double hitTime = elapsed(start);
+
+	start = clock();
+	for (uint i = 0; i < kLookupRounds; ++i)
+		checksum += map.contains(missingKeys[(i * 7919) % count]);
+	const double missTime = elapsed(start);
+
+	start = clock();
+	for (uint i = 0; i < count; i += 2)
+		map.erase(keys[i]);
+	for (uint i = 0; i < kLookupRounds; ++i)
+		checksum += map.contains(keys[(i * 7919) % count]);
+	const double eraseTime = elapsed(start);
+
+	printf("%-26s insert %8.2f ms  hit %8.2f ms  miss %8.2f ms  erase+lookup %8.2f ms  (%u)\n",
+	       name, insertTime, hitTime, missTime, eraseTime, checksum);
+}
+
+int main(int argc, char *argv[]) {
+	const uint count = (argc > 1) ? MAX(atoi(argv[1]), 1) : 1000;
+	printf("%u entries, %d lookups per phase\n", count, kLookupRounds);
+
+	uint *intKeys = new uint[count];
+	uint *missingIntKeys = new uint[count];
+	Common::String *stringKeys = new Common::String[count];
+	Common::String *missingStringKeys = new Common::String[count];
+	for (uint i = 0; i < count; ++i) {
+		// Sequential keys like the object handles of the engines
+		intKeys[i] = i + 1;
+		missingIntKeys[i] = count + i + 1;
+		stringKeys[i] = Common::String::format("resource%05u.dat", i);
+		missingStringKeys[i] = Common::String::format("missing%05u.dat", i);
+	}
+
+	benchmark<Common::HashMap<uint, uint>, uint>("HashMap<uint>", intKeys, missingIntKeys, count);
+	benchmark<Common::FlatHashMap<uint, uint>, uint>("FlatHashMap<uint>", intKeys, missingIntKeys, count);
+	benchmark<Common::HashMap<Common::String, uint>, Common::String>("HashMap<String>", stringKeys, missingStringKeys, count);
+	benchmark<Common::FlatHashMap<Common::String, uint>, Common::String>("FlatHashMap<String>", stringKeys, missingStringKeys, count);
+
+	delete[] intKeys;
+	delete[] missingIntKeys;
+	delete[] stringKeys;
+	delete[] missingStringKeys;
+	return 0;
+}
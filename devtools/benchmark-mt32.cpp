@@ -0,0 +1,228 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Render benchmark for the MT-32 emulator. Plays a MIDI file, or a fixed
+// built-in sequence, through MT32Emu::Synth as fast as possible and prints
+// the real-time factor.
+//
+// Usage: benchmark-mt32 <control ROM> <PCM ROM> [MIDI file]
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/scummsys.h"
+
+#ifdef USE_MT32EMU
+
+#include "audio/softsynth/mt32/mt32emu.h"
+#include "audio/softsynth/mt32/ROMInfo.h"
+#include "audio/mididrv.h"
+#include "audio/midiparser.h"
+
+#include "common/file.h"
+#include "common/memstream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum {
+	/** Interval of the simulated MIDI timer in microseconds */
+	kTimerRate = 4000,
+	/** Samples rendered per MIDI timer tick */
+	kSamplesPerTick = MT32Emu::SAMPLE_RATE * kTimerRate / 1000000,
+	/** Length of the built-in sequence in timer ticks (one minute) */
+	kBuiltinTicks = 60 * 1000000 / kTimerRate
+};
+
+/** Forwards the MIDI events of a parser to the emulator. */
+class SynthDriver : public MidiDriver_BASE {
+public:
+	SynthDriver(MT32Emu::Synth *synth) : _synth(synth) {}
+
+	void send(uint32 b) {
+		_synth->playMsg(b);
+	}
+
+	void sysEx(const byte *msg, uint16 length) {
+		if (msg[0] == 0xf0)
+			_synth->playSysex(msg, length);
+		else
+			_synth->playSysexWithoutFraming(msg, length);
+	}
+
+private:
+	MT32Emu::Synth *_synth;
+};
+
+static Common::File *openROM(const char *path) {
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return 0;
+
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	byte *data = (byte *)malloc(size);
+	if (fread(data, 1, size, f) != (size_t)size) {
+		free(data);
+		fclose(f);
+		return 0;
+	}
+	fclose(f);
+
+	Common::File *file = new Common::File();
+	file->open(new Common::MemoryReadStream(data, size, DisposeAfterUse::YES), path);
+	return file;
+}
+
+static byte *loadFile(const char *path, uint32 &size) {
+	FILE *f = fopen(path, "rb");
+	if (!f)
+		return 0;
+
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	byte *data = (byte *)malloc(size);
+	if (fread(data, 1, size, f) != size) {
+		free(data);
+		data = 0;
+	}
+	fclose(f);
+	return data;
+}
+
+/**
+ * Send the events of the built-in sequence for the given tick: sustained
+ * chords on the eight melodic parts plus a drum pattern, so that most of
+ * the 32 partials are busy.
+ */
+static void playBuiltinTick(MT32Emu::Synth *synth, uint tick) {
+	static const byte chords[4][3] = {
+		{ 48, 52, 55 }, { 45, 48, 52 }, { 41, 45, 48 }, { 43, 47, 50 }
+	};
+
+	if (tick % 125 == 0) {
+		const uint bar = tick / 125;
+		for (uint part = 0; part < 8; ++part) {
+			const byte channel = part + 1;
+			const byte *chord = chords[bar % 4];
+			const byte *lastChord = chords[(bar + 3) % 4];
+			const byte octave = 12 * (part % 3);
+
+			if (bar == 0)
+				synth->playMsg(0xC0 | channel | ((part * 9) << 8));
+			else
+				synth->playMsg(0x80 | channel | ((lastChord[part % 3] + octave) << 8));
+			synth->playMsg(0x90 | channel | ((chord[part % 3] + octave) << 8) | (100 << 16));
+		}
+	}
+
+	if (tick % 31 == 0) {
+		static const byte drums[4] = { 36, 42, 38, 42 };
+		const byte note = drums[(tick / 31) % 4];
+		synth->playMsg(0x99 | (note << 8) | (110 << 16));
+	}
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 3) {
+		printf("Usage: %s <control ROM> <PCM ROM> [MIDI file]\n", argv[0]);
+		return 1;
+	}
+
+	Common::File *controlFile = openROM(argv[1]);
+	Common::File *pcmFile = openROM(argv[2]);
+	if (!controlFile || !pcmFile) {
+		printf("Could not read the ROM files\n");
+		return 1;
+	}
+
+	const MT32Emu::ROMImage *controlROM = MT32Emu::ROMImage::makeROMImage(controlFile);
+	const MT32Emu::ROMImage *pcmROM = MT32Emu::ROMImage::makeROMImage(pcmFile);
+	MT32Emu::Synth *synth = new MT32Emu::Synth();
+	if (!synth->open(*controlROM, *pcmROM)) {
+		printf("Could not open the emulator, the ROMs are not recognized\n");
+		return 1;
+	}
+
+	SynthDriver driver(synth);
+	MidiParser *parser = 0;
+	byte *midiData = 0;
+	if (argc > 3) {
+		uint32 midiSize;
+		midiData = loadFile(argv[3], midiSize);
+		parser = MidiParser::createParser_SMF();
+		if (!midiData || !parser->loadMusic(midiData, midiSize)) {
+			printf("Could not load MIDI file %s\n", argv[3]);
+			return 1;
+		}
+		parser->setMidiDriver(&driver);
+		parser->setTimerRate(kTimerRate);
+		parser->setTrack(0);
+	}
+
+	int16 buffer[kSamplesPerTick * 2];
+	uint32 ticks = 0;
+
+	const clock_t start = clock();
+	if (parser) {
+		while (parser->isPlaying()) {
+			parser->onTimer();
+			synth->render(buffer, kSamplesPerTick);
+			++ticks;
+		}
+	} else {
+		for (; ticks < kBuiltinTicks; ++ticks) {
+			playBuiltinTick(synth, ticks);
+			synth->render(buffer, kSamplesPerTick);
+		}
+	}
+	const double renderTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+	const double audioTime = (double)ticks * kTimerRate / 1000000.0;
+
+	printf("Rendered %.1f s of audio in %.2f s, real-time factor %.2f\n",
+	       audioTime, renderTime, renderTime > 0 ? audioTime / renderTime : 0.0);
+
+	delete parser;
+	free(midiData);
+	synth->close();
+	delete synth;
+	MT32Emu::ROMImage::freeROMImage(controlROM);
+	MT32Emu::ROMImage::freeROMImage(pcmROM);
+	delete controlFile;
+	delete pcmFile;
+	return 0;
+}
+
+#else
+
+#include <stdio.h>
+
+int main(int argc, char *argv[]) {
+	printf("The MT-32 emulator is not enabled in this build\n");
+	return 1;
+}
+
+#endif
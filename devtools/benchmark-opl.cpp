@@ -0,0 +1,195 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Render benchmark for the DOSBox OPL emulator. Replays an OPL register
+// capture in DOSBox's DRO 2.0 format as fast as possible and prints the
+// real-time factor. Without a capture, a built-in register write stress
+// test is rendered for OPL2, dual OPL2 and OPL3.
+//
+// Usage: benchmark-opl [capture.dro]
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "audio/softsynth/opl/dosbox.h"
+
+#include "common/endian.h"
+#include "common/util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+enum {
+	kRate = 44100,
+	/** Length of the built-in stress test in seconds */
+	kStressSeconds = 60
+};
+
+static int16 s_buffer[2 * kRate / 10];
+
+/** Render the given number of samples per channel. */
+static void render(OPL::DOSBox::OPL &opl, bool stereo, uint32 samples) {
+	const uint32 chunk = ARRAYSIZE(s_buffer) / 2;
+	while (samples > 0) {
+		const uint32 count = MIN(samples, chunk);
+		opl.readBuffer(s_buffer, stereo ? count * 2 : count);
+		samples -= count;
+	}
+}
+
+static void printResult(const char *name, uint32 samples, clock_t start) {
+	const double renderTime = (double)(clock() - start) / CLOCKS_PER_SEC;
+	const double audioTime = (double)samples / kRate;
+	printf("%-10s rendered %.1f s of audio in %.2f s, real-time factor %.1f\n",
+	       name, audioTime, renderTime, renderTime > 0 ? audioTime / renderTime : 0.0);
+}
+
+/**
+ * Write pseudo random values to all registers between chunks of output.
+ * Rhythm mode is switched on most of the time. The timer registers are
+ * skipped, since they depend on the real time.
+ */
+static void stressTest(const char *name, OPL::Config::OplType type) {
+	OPL::DOSBox::OPL opl(type);
+	opl.init(kRate);
+
+	const bool stereo = (type != OPL::Config::kOpl2);
+	const int maxRegister = (type == OPL::Config::kOpl3) ? 0x200 : 0x100;
+	if (type == OPL::Config::kOpl3)
+		opl.writeReg(0x105, 1);
+
+	uint32 random = 12345;
+	uint32 rendered = 0;
+
+	const clock_t start = clock();
+	while (rendered < kStressSeconds * kRate) {
+		for (int i = 0; i < 8; ++i) {
+			random = random * 1103515245 + 12345;
+			int reg = (random >> 8) % maxRegister;
+			int val = (random >> 20) & 0xff;
+
+			if ((reg & 0xff) < 0x20 || reg == 0x105)
+				continue;
+			if ((reg & 0xff) == 0xbd && (random & 0x7))
+				val |= 0x20;
+			opl.writeReg(reg, val);
+		}
+
+		random = random * 1103515245 + 12345;
+		const uint32 samples = 1 + (random >> 16) % 1024;
+		render(opl, stereo, samples);
+		rendered += samples;
+	}
+	printResult(name, rendered, start);
+}
+
+/** Replay a DOSBox DRO 2.0 capture. */
+static int replay(const char *filename) {
+	FILE *f = fopen(filename, "rb");
+	if (!f) {
+		printf("Could not open %s\n", filename);
+		return 1;
+	}
+
+	fseek(f, 0, SEEK_END);
+	const long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	byte *data = (byte *)malloc(size);
+	const bool readOk = (fread(data, 1, size, f) == (size_t)size);
+	fclose(f);
+
+	if (!readOk || size < 26 || memcmp(data, "DBRAWOPL", 8) || READ_LE_UINT16(data + 8) != 2) {
+		printf("%s is not a DRO 2.0 file\n", filename);
+		free(data);
+		return 1;
+	}
+
+	const uint32 numPairs = READ_LE_UINT32(data + 12);
+	const byte hardware = data[20];
+	const byte shortDelayCode = data[23];
+	const byte longDelayCode = data[24];
+	const byte codemapLength = data[25];
+	const byte *codemap = data + 26;
+	const byte *pairs = codemap + codemapLength;
+	if (pairs + numPairs * 2 > data + size || codemapLength > 128) {
+		printf("%s is truncated\n", filename);
+		free(data);
+		return 1;
+	}
+
+	const OPL::Config::OplType type = (hardware == 0) ? OPL::Config::kOpl2 : (hardware == 1) ? OPL::Config::kDualOpl2 : OPL::Config::kOpl3;
+	const bool stereo = (type != OPL::Config::kOpl2);
+	OPL::DOSBox::OPL opl(type);
+	opl.init(kRate);
+
+	uint32 rendered = 0;
+	uint32 delayMs = 0;
+
+	const clock_t start = clock();
+	for (uint32 i = 0; i < numPairs; ++i) {
+		const byte index = pairs[i * 2];
+		const byte val = pairs[i * 2 + 1];
+
+		if (index == shortDelayCode || index == longDelayCode) {
+			delayMs += (index == shortDelayCode) ? val + 1 : (val + 1) << 8;
+			// Render the delay in whole samples, keeping the remainder
+			const uint32 samples = (uint64)delayMs * kRate / 1000 - rendered;
+			render(opl, stereo, samples);
+			rendered += samples;
+		} else if ((index & 0x7f) < codemapLength) {
+			const int reg = codemap[index & 0x7f];
+			// The timer registers need a running OSystem for the time,
+			// and do not affect the output.
+			if (reg >= 0x02 && reg <= 0x04)
+				continue;
+
+			if (index & 0x80) {
+				if (type == OPL::Config::kDualOpl2) {
+					opl.write(0x222, reg);
+					opl.write(0x223, val);
+				} else {
+					opl.writeReg(0x100 | reg, val);
+				}
+			} else if (type == OPL::Config::kDualOpl2) {
+				opl.write(0x220, reg);
+				opl.write(0x221, val);
+			} else {
+				opl.writeReg(reg, val);
+			}
+		}
+	}
+	printResult(filename, rendered, start);
+
+	free(data);
+	return 0;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc > 1)
+		return replay(argv[1]);
+
+	stressTest("OPL2", OPL::Config::kOpl2);
+	stressTest("Dual OPL2", OPL::Config::kDualOpl2);
+	stressTest("OPL3", OPL::Config::kOpl3);
+	return 0;
+}
@@ -12,7 +12,10 @@ MODULE_DIRS += \
 DEVTOOLS := \
 	devtools/convbdf$(EXEEXT) \
 	devtools/md5table$(EXEEXT) \
-	devtools/make-scumm-fontdata$(EXEEXT)
+	devtools/make-scumm-fontdata$(EXEEXT) \
+	devtools/benchmark-hashmap$(EXEEXT) \
+	devtools/benchmark-mt32$(EXEEXT) \
+	devtools/benchmark-opl$(EXEEXT)
 
 include $(srcdir)/devtools/*/module.mk
 
@@ -44,6 +47,18 @@ devtools/make-scumm-fontdata$(EXEEXT): $(srcdir)/devtools/make-scumm-fontdata.c
 	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
 	$(QUIET_LINK)$(LD) $(CFLAGS) -Wall -o $@ $<
 
+devtools/benchmark-hashmap$(EXEEXT): $(srcdir)/devtools/benchmark-hashmap.cpp common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(LD) $(CXXFLAGS) $(CPPFLAGS) -Wall -o $@ $+ $(LIBS)
+
+devtools/benchmark-mt32$(EXEEXT): $(srcdir)/devtools/benchmark-mt32.cpp audio/softsynth/mt32/libmt32.a audio/libaudio.a common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(LD) $(CXXFLAGS) $(CPPFLAGS) -Wall -o $@ $+ $(LIBS)
+
+devtools/benchmark-opl$(EXEEXT): $(srcdir)/devtools/benchmark-opl.cpp audio/libaudio.a common/libcommon.a
+	$(QUIET)$(MKDIR) devtools/$(DEPDIR)
+	$(QUIET_LINK)$(LD) $(CXXFLAGS) $(CPPFLAGS) -Wall -o $@ $+ $(LIBS)
+
 #
 # Rules to explicitly rebuild the credits / MD5 tables.
 # The rules for the files in the "web" resp. "docs" modules
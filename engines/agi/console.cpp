@@ -48,6 +48,7 @@ Console::Console(AgiEngine *vm) : GUI::Debugger() {
 	DCmd_Register("setobj",     WRAP_METHOD(Console, Cmd_SetObj));
 	DCmd_Register("room",       WRAP_METHOD(Console, Cmd_Room));
 	DCmd_Register("bt",         WRAP_METHOD(Console, Cmd_BT));
+	DCmd_Register("benchmark_pictures", WRAP_METHOD(Console, Cmd_BenchmarkPictures));
 }
 
 bool Console::Cmd_SetVar(int argc, const char **argv) {
@@ -241,6 +242,55 @@ bool Console::Cmd_Room(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_BenchmarkPictures(int argc, const char **argv) {
+	if (_vm->getFeatures() & (GF_AGI256 | GF_AGI256_2)) {
+		DebugPrintf("The pictures of this game are not drawn by the picture decoder\n");
+		return true;
+	}
+
+	const int repeat = (argc > 1) ? MAX(1, atoi(argv[1])) : 1;
+
+	// The pictures are drawn into the screen buffer, which is restored
+	// afterwards. They are decoded from their data, so neither the picture
+	// cache nor the image stack of the savegames is used.
+	const int size = _DEFAULT_WIDTH * _DEFAULT_HEIGHT;
+	uint8 *screen = new uint8[size];
+	memcpy(screen, _vm->_game.sbuf16c, size);
+
+	int count = 0;
+	uint32 length = 0;
+	uint32 time = 0;
+
+	for (int n = 0; n < MAX_DIRS; n++) {
+		if (_vm->_game.dirPic[n].offset == _EMPTY)
+			continue;
+
+		const bool loaded = (_vm->_game.dirPic[n].flags & RES_LOADED) != 0;
+		if (!loaded && _vm->agiLoadResource(rPICTURE, n) != errOK)
+			continue;
+
+		const uint32 start = _vm->_system->getMillis();
+		for (int i = 0; i < repeat; i++)
+			_vm->_picture->decodePicture(_vm->_game.pictures[n].rdata, _vm->_game.dirPic[n].len, 1);
+		time += _vm->_system->getMillis() - start;
+
+		count++;
+		length += _vm->_game.dirPic[n].len;
+
+		if (!loaded)
+			_vm->agiUnloadResource(rPICTURE, n);
+	}
+
+	memcpy(_vm->_game.sbuf16c, screen, size);
+	delete[] screen;
+
+	DebugPrintf("Drew %d pictures of %d bytes %d times in %d ms\n", count, length, repeat, time);
+	if (count > 0)
+		DebugPrintf("%.2f ms per picture\n", (double)time / (count * repeat));
+
+	return true;
+}
+
 bool Console::Cmd_BT(int argc, const char **argv) {
 	DebugPrintf("Current script: %d\nStack depth: %d\n", _vm->_game.lognum, _vm->_game.execStack.size());
 
@@ -61,6 +61,7 @@ private:
 	bool Cmd_Cont(int argc, const char **argv);
 	bool Cmd_Room(int argc, const char **argv);
 	bool Cmd_BT(int argc, const char **argv);
+	bool Cmd_BenchmarkPictures(int argc, const char **argv);
 
 private:
 	AgiEngine *_vm;
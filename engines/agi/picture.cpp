@@ -41,6 +41,19 @@ PictureMgr::PictureMgr(AgiBase *agi, GfxMgr *gfx) {
 	_minCommand = 0xf0;
 	_flags = 0;
 	_currentStep = 0;
+
+	_fillStack.reserve(256);
+
+	for (int i = 0; i < kPictureCacheSize; i++) {
+		_pictureCache[i].resNum = -1;
+		_pictureCache[i].buffer = NULL;
+	}
+	_pictureCacheCounter = 0;
+}
+
+PictureMgr::~PictureMgr() {
+	for (int i = 0; i < kPictureCacheSize; i++)
+		free(_pictureCache[i].buffer);
 }
 
 void PictureMgr::putVirtPixel(int x, int y) {
@@ -60,6 +73,42 @@ void PictureMgr::putVirtPixel(int x, int y) {
 		*p = _scrColor | (*p & 0xf0);
 }
 
+/**
+ * Draw a horizontal or vertical run of pixels, like calling putVirtPixel()
+ * for each of them.
+ */
+void PictureMgr::putVirtRun(int x, int y, int count, bool vertical) {
+	x += _xOffset;
+	y += _yOffset;
+
+	if (vertical) {
+		if (x < 0 || x >= _width)
+			return;
+		if (y < 0) {
+			count += y;
+			y = 0;
+		}
+		count = MIN(count, _height - y);
+	} else {
+		if (y < 0 || y >= _height)
+			return;
+		if (x < 0) {
+			count += x;
+			x = 0;
+		}
+		count = MIN(count, _width - x);
+	}
+
+	// Bits of the pixels kept and set by putVirtPixel()
+	const uint8 keep = (_priOn ? 0x0f : 0xff) & (_scrOn ? 0xf0 : 0xff);
+	const uint8 set = (_priOn ? (uint8)(_priColor << 4) : 0) | (_scrOn ? _scrColor : 0);
+	const int step = vertical ? _width : 1;
+
+	uint8 *p = &_vm->_game.sbuf16c[y * _width + x];
+	for (; count > 0; count--, p += step)
+		*p = (*p & keep) | set;
+}
+
 #if 0
 static void drawProc(int x, int y, int c, void *data) {
 	((PictureMgr *)data)->putVirtPixel(x, y);
@@ -93,9 +142,7 @@ void PictureMgr::drawLine(int x1, int y1, int x2, int y2) {
 			SWAP(y1, y2);
 		}
 
-		for (; y1 <= y2; y1++)
-			putVirtPixel(x1, y1);
-
+		putVirtRun(x1, y1, y2 - y1 + 1, true);
 		return;
 	}
 
@@ -105,8 +152,8 @@ void PictureMgr::drawLine(int x1, int y1, int x2, int y2) {
 		if (x1 > x2) {
 			SWAP(x1, x2);
 		}
-		for (; x1 <= x2; x1++)
-			putVirtPixel(x1, y1);
+
+		putVirtRun(x1, y1, x2 - x1 + 1, false);
 		return;
 	}
 
@@ -228,16 +275,16 @@ void PictureMgr::absoluteDrawLine() {
 ** okToFill
 **************************************************************************/
 int PictureMgr::isOkFillHere(int x, int y) {
-	uint8 p;
-
 	x += _xOffset;
 	y += _yOffset;
 
 	if (x < 0 || x >= _width || y < 0 || y >= _height)
 		return false;
 
-	p = _vm->_game.sbuf16c[y * _width + x];
+	return isOkFillPixel(_vm->_game.sbuf16c[y * _width + x]);
+}
 
+bool PictureMgr::isOkFillPixel(uint8 p) {
 	if (_flags & kPicFTrollMode)
 		return ((p & 0x0f) != 11 && (p & 0x0f) != _scrColor);
 
@@ -257,43 +304,62 @@ void PictureMgr::agiFill(unsigned int x, unsigned int y) {
 	if (!_scrOn && !_priOn)
 		return;
 
-	// Push initial pixel on the stack
-	Common::Stack<Common::Point> stack;
-	stack.push(Common::Point(x,y));
+	if (!isOkFillHere(x, y))
+		return;
+
+	// Bits of the pixels kept and set by putVirtPixel()
+	const uint8 keep = (_priOn ? 0x0f : 0xff) & (_scrOn ? 0xf0 : 0xff);
+	const uint8 set = (_priOn ? (uint8)(_priColor << 4) : 0) | (_scrOn ? _scrColor : 0);
+
+	// Whether each pixel value can be filled
+	bool fillable[256];
+	for (int i = 0; i < 256; i++)
+		fillable[i] = isOkFillPixel(i);
+
+	// Push initial pixel on the stack, in screen buffer coordinates
+	_fillStack.push_back(Common::Point(x + _xOffset, y + _yOffset));
 
 	// Exit if stack is empty
-	while (!stack.empty()) {
-		Common::Point p = stack.pop();
-		unsigned int c;
-		int newspanUp, newspanDown;
+	while (!_fillStack.empty()) {
+		Common::Point p = _fillStack.back();
+		_fillStack.pop_back();
 
-		if (!isOkFillHere(p.x, p.y))
+		uint8 *row = &_vm->_game.sbuf16c[p.y * _width];
+		if (!fillable[row[p.x]])
 			continue;
 
-		// Scan for left border
-		for (c = p.x - 1; isOkFillHere(c, p.y); c--)
-			;
-
-		newspanUp = newspanDown = 1;
-		for (c++; isOkFillHere(c, p.y); c++) {
-			putVirtPixel(c, p.y);
-			if (isOkFillHere(c, p.y - 1)) {
-				if (newspanUp) {
-					stack.push(Common::Point(c,p.y-1));
-					newspanUp = 0;
-				}
-			} else {
-				newspanUp = 1;
-			}
+		// Scan for the borders of the span
+		int left = p.x;
+		while (left > 0 && fillable[row[left - 1]])
+			left--;
+		int right = p.x;
+		while (right < _width - 1 && fillable[row[right + 1]])
+			right++;
+
+		for (int c = left; c <= right; c++)
+			row[c] = (row[c] & keep) | set;
+
+		// Continue with the spans above and below
+		if (p.y > 0)
+			pushFillSpans(fillable, row - _width, left, right, p.y - 1);
+		if (p.y < _height - 1)
+			pushFillSpans(fillable, row + _width, left, right, p.y + 1);
+	}
+}
 
-			if (isOkFillHere(c, p.y + 1)) {
-				if (newspanDown) {
-					stack.push(Common::Point(c,p.y+1));
-					newspanDown = 0;
-				}
-			} else {
-				newspanDown = 1;
+/**
+ * Push the start of each span of fillable pixels between left and right.
+ */
+void PictureMgr::pushFillSpans(const bool *fillable, const uint8 *row, int left, int right, int y) {
+	bool newSpan = true;
+	for (int c = left; c <= right; c++) {
+		if (fillable[row[c]]) {
+			if (newSpan) {
+				_fillStack.push_back(Common::Point(c, y));
+				newSpan = false;
 			}
+		} else {
+			newSpan = true;
 		}
 	}
 }
@@ -824,7 +890,13 @@ int PictureMgr::decodePicture(int n, int clr, bool agi256, int pic_width, int pi
 		memset(_vm->_game.sbuf16c, 0x4f, _width * _height); // Clear 16 color AGI screen (Priority 4, color white).
 
 	if (!agi256) {
-		drawPicture(); // Draw 16 color picture.
+		// Pictures drawn on a cleared screen always look the same
+		if (!clr || !getCachedPicture(n)) {
+			drawPicture(); // Draw 16 color picture.
+
+			if (clr)
+				addCachedPicture(n);
+		}
 	} else {
 		const uint32 maxFlen = _width * _height;
 		memcpy(_vm->_game.sbuf256c, _data, MIN(_flen, maxFlen)); // Draw 256 color picture.
@@ -890,6 +962,62 @@ int PictureMgr::unloadPicture(int n) {
 	return errOK;
 }
 
+/**
+ * Copy the cached screen buffer of a picture resource to the AGI screen.
+ * @param n AGI picture resource number
+ * @return true if the picture was cached
+ */
+bool PictureMgr::getCachedPicture(int n) {
+	if (_flags & kPicFStep)
+		return false;
+
+	for (int i = 0; i < kPictureCacheSize; i++) {
+		CachedPicture &entry = _pictureCache[i];
+		if (entry.resNum == n && entry.length == _flen && entry.version == _pictureVersion &&
+			entry.flags == _flags && entry.width == _width && entry.height == _height &&
+			entry.xOffset == _xOffset && entry.yOffset == _yOffset) {
+			memcpy(_vm->_game.sbuf16c, entry.buffer, _width * _height);
+			entry.lastUsed = ++_pictureCacheCounter;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * Cache the AGI screen as the screen buffer of a picture resource, replacing
+ * the least recently used picture.
+ * @param n AGI picture resource number
+ */
+void PictureMgr::addCachedPicture(int n) {
+	if (_flags & kPicFStep)
+		return;
+
+	CachedPicture *entry = &_pictureCache[0];
+	for (int i = 1; i < kPictureCacheSize && entry->resNum != -1; i++) {
+		if (_pictureCache[i].resNum == -1 || _pictureCache[i].lastUsed < entry->lastUsed)
+			entry = &_pictureCache[i];
+	}
+
+	entry->buffer = (uint8 *)realloc(entry->buffer, _width * _height);
+	if (!entry->buffer) {
+		entry->resNum = -1;
+		return;
+	}
+
+	memcpy(entry->buffer, _vm->_game.sbuf16c, _width * _height);
+	entry->resNum = n;
+	entry->length = _flen;
+	entry->version = _pictureVersion;
+	entry->flags = _flags;
+	entry->width = _width;
+	entry->height = _height;
+	entry->xOffset = _xOffset;
+	entry->yOffset = _yOffset;
+	entry->lastUsed = ++_pictureCacheCounter;
+}
+
 void PictureMgr::clear() {
 	memset(_vm->_game.sbuf16c, 0x4f, _width * _height);
 }
@@ -23,6 +23,9 @@
 #ifndef AGI_PICTURE_H
 #define AGI_PICTURE_H
 
+#include "common/array.h"
+#include "common/rect.h"
+
 namespace Agi {
 
 #define _DEFAULT_WIDTH		160
@@ -63,10 +66,13 @@ class PictureMgr {
 private:
 
 	void drawLine(int x1, int y1, int x2, int y2);
+	void putVirtRun(int x, int y, int count, bool vertical);
 	void dynamicDrawLine();
 	void absoluteDrawLine();
 	int isOkFillHere(int x, int y);
+	bool isOkFillPixel(uint8 p);
 	void agiFill(unsigned int x, unsigned int y);
+	void pushFillSpans(const bool *fillable, const uint8 *row, int left, int right, int y);
 	void xCorner(bool skipOtherCoords = false);
 	void yCorner(bool skipOtherCoords = false);
 	void fill();
@@ -75,8 +81,12 @@ private:
 
 	uint8 nextByte() { return _data[_foffs++]; }
 
+	bool getCachedPicture(int n);
+	void addCachedPicture(int n);
+
 public:
 	PictureMgr(AgiBase *agi, GfxMgr *gfx);
+	~PictureMgr();
 
 	void putVirtPixel(int x, int y);
 
@@ -137,6 +147,31 @@ private:
 
 	int _flags;
 	int _currentStep;
+
+	/** Starting points of the spans still to be filled by agiFill() */
+	Common::Array<Common::Point> _fillStack;
+
+	enum {
+		kPictureCacheSize = 8
+	};
+
+	/**
+	 * Screen buffer of a picture resource drawn on a cleared screen. Drawing
+	 * the same room again only has to copy it back.
+	 */
+	struct CachedPicture {
+		int resNum;			/**< picture resource number, -1 if unused */
+		uint32 length;		/**< size of the picture resource */
+		AgiPictureVersion version;
+		int flags;
+		int width, height;
+		int xOffset, yOffset;
+		uint32 lastUsed;
+		uint8 *buffer;
+	};
+
+	CachedPicture _pictureCache[kPictureCacheSize];
+	uint32 _pictureCacheCounter;
 };
 
 } // End of namespace Agi
@@ -0,0 +1,216 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/detectioncache.h"
+
+#include "common/debug.h"
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+#define DETECTION_CACHE_FILENAME "detection.idx"
+#define DETECTION_CACHE_SIGNATURE MKTAG('D','C','I','X')
+#define DETECTION_CACHE_VERSION 1
+
+enum {
+	/** Maximum number of entries written to the index */
+	kMaxIndexEntries = 50000
+};
+
+static Common::String readIndexString(Common::ReadStream *stream) {
+	Common::String str;
+	const uint32 len = stream->readUint32LE();
+	for (uint32 i = 0; i < len && !stream->eos(); ++i)
+		str += (char)stream->readByte();
+	return str;
+}
+
+static void writeIndexString(Common::WriteStream *stream, const Common::String &str) {
+	stream->writeUint32LE(str.size());
+	stream->writeString(str);
+}
+
+DetectionCache::DetectionCache() : _loaded(false), _dirty(false), _scanDepth(0), _scanStart(0) {
+	memset(&_stats, 0, sizeof(_stats));
+}
+
+Common::String DetectionCache::makeKey(const Common::String &path, uint32 md5Bytes) {
+	return Common::String::format("%u:%s", md5Bytes, path.c_str());
+}
+
+void DetectionCache::beginScan() {
+	if (_scanDepth++ > 0)
+		return;
+
+	if (!_loaded)
+		load();
+
+	memset(&_stats, 0, sizeof(_stats));
+	_scanStart = g_system->getMillis();
+}
+
+void DetectionCache::endScan() {
+	assert(_scanDepth > 0);
+	if (--_scanDepth > 0)
+		return;
+
+	// Files without a known modification time are only cached for the
+	// duration of a scan, since there is no way to tell if they changed.
+	for (EntryMap::iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (!i->_value.mtime)
+			_entries.erase(i);
+	}
+
+	if (_dirty)
+		save();
+
+	_stats.time = g_system->getMillis() - _scanStart;
+	debug(1, "DetectionCache: %u files, %u cached, %u KB hashed in %u ms",
+	      _stats.files, _stats.hits, (uint32)(_stats.bytesHashed / 1024), _stats.time);
+}
+
+bool DetectionCache::getFileProperties(const Common::FSNode &node, uint32 md5Bytes, int32 &size, Common::String &md5) {
+	const Common::String key = makeKey(node.getPath(), md5Bytes);
+	const uint32 mtime = node.getModificationTime();
+	const int32 fileSize = node.getFileSize();
+
+	++_stats.files;
+
+	// A file replaced within the resolution of the modification time is
+	// still noticed if its size changed
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		if (i->_value.mtime == mtime && (fileSize < 0 || i->_value.size == fileSize)) {
+			i->_value.used = true;
+			size = i->_value.size;
+			md5 = i->_value.md5;
+			++_stats.hits;
+			return true;
+		}
+
+		_entries.erase(i);
+		_dirty = true;
+	}
+
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream)
+		return false;
+
+	size = stream->size();
+	md5 = Common::computeStreamMD5AsString(*stream, md5Bytes);
+	delete stream;
+
+	_stats.bytesHashed += md5Bytes ? MIN<uint32>(size, md5Bytes) : size;
+
+	if (_scanDepth > 0 || mtime) {
+		Entry &entry = _entries[key];
+		entry.size = size;
+		entry.mtime = mtime;
+		entry.md5 = md5;
+		entry.used = true;
+
+		if (mtime)
+			_dirty = true;
+	}
+
+	return true;
+}
+
+void DetectionCache::load() {
+	_loaded = true;
+
+	Common::InSaveFile *file = g_system->getSavefileManager()->openForLoading(DETECTION_CACHE_FILENAME);
+	if (!file)
+		return;
+
+	if (file->readUint32BE() != DETECTION_CACHE_SIGNATURE || file->readUint32LE() != DETECTION_CACHE_VERSION) {
+		warning("DetectionCache: Ignoring invalid index '%s'", DETECTION_CACHE_FILENAME);
+		delete file;
+		return;
+	}
+
+	const uint32 count = file->readUint32LE();
+	for (uint32 n = 0; n < count && !file->eos() && !file->err(); ++n) {
+		Common::String key = readIndexString(file);
+		Entry entry;
+		entry.size = file->readSint32LE();
+		entry.mtime = file->readUint32LE();
+		entry.md5 = readIndexString(file);
+		entry.used = false;
+
+		if (file->eos() || file->err())
+			break;
+
+		_entries[key] = entry;
+	}
+
+	debug(2, "DetectionCache: Loaded %u entries", _entries.size());
+	delete file;
+}
+
+void DetectionCache::save() {
+	_dirty = false;
+
+	Common::OutSaveFile *file = g_system->getSavefileManager()->openForSaving(DETECTION_CACHE_FILENAME);
+	if (!file) {
+		warning("DetectionCache: Could not write index '%s'", DETECTION_CACHE_FILENAME);
+		return;
+	}
+
+	// Entries used since loading the index come first, so they survive
+	// when the index grows too large.
+	uint32 count = 0;
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		if (i->_value.used)
+			++count;
+	}
+	const uint32 unused = MIN<uint32>(_entries.size() - count, MAX<int>(kMaxIndexEntries - (int)count, 0));
+	count = MIN<uint32>(count, kMaxIndexEntries) + unused;
+
+	file->writeUint32BE(DETECTION_CACHE_SIGNATURE);
+	file->writeUint32LE(DETECTION_CACHE_VERSION);
+	file->writeUint32LE(count);
+
+	for (int pass = 0; pass < 2; ++pass) {
+		for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end() && count > 0; ++i) {
+			if (i->_value.used != (pass == 0))
+				continue;
+
+			writeIndexString(file, i->_key);
+			file->writeSint32LE(i->_value.size);
+			file->writeUint32LE(i->_value.mtime);
+			writeIndexString(file, i->_value.md5);
+			--count;
+		}
+	}
+
+	file->finalize();
+	if (file->err())
+		warning("DetectionCache: Could not write index '%s'", DETECTION_CACHE_FILENAME);
+	delete file;
+}
@@ -0,0 +1,99 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+class FSNode;
+}
+
+/**
+ * Cache of file sizes and MD5 checksums computed during game detection.
+ *
+ * All engine detectors share this cache, so a file probed by several engines
+ * is only read once per detection pass. Results for files whose modification
+ * time is known are additionally kept in an index in the save directory, so
+ * that re-scanning a game library skips files whose modification time and
+ * size did not change since.
+ *
+ * A detection pass is enclosed in beginScan() and endScan(). These calls may
+ * be nested, e.g. the mass add dialog encloses its whole scan, which runs
+ * many detection passes. The index is written when the outermost pass ends.
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	struct Stats {
+		uint32 files;		///< Number of file properties requested
+		uint32 hits;		///< Number of requests served from the cache
+		uint64 bytesHashed;	///< Number of bytes read for computing checksums
+		uint32 time;		///< Duration of the scan in milliseconds
+	};
+
+	void beginScan();
+	void endScan();
+
+	/**
+	 * Return the size of a file and the MD5 checksum of its first md5Bytes
+	 * bytes (or of the whole file if md5Bytes is 0).
+	 *
+	 * @return true on success, false if the file could not be read
+	 */
+	bool getFileProperties(const Common::FSNode &node, uint32 md5Bytes, int32 &size, Common::String &md5);
+
+	/** Return the statistics of the current or last finished scan. */
+	const Stats &getStats() const { return _stats; }
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	DetectionCache();
+
+	struct Entry {
+		int32 size;
+		/** Modification time of the file, 0 if unknown */
+		uint32 mtime;
+		Common::String md5;
+		/** Whether the entry was used since the index was loaded */
+		bool used;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(const Common::String &path, uint32 md5Bytes);
+
+	void load();
+	void save();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+	int _scanDepth;
+	uint32 _scanStart;
+	Stats _stats;
+};
+
+#endif
@@ -33,6 +33,20 @@ CellGame::CellGame() {
 	_coeff3 = 0;
 
 	_moveCount = 0;
+
+	_transpositionTable = new TranspositionEntry[kTranspositionTableSize];
+	memset(_transpositionTable, 0, kTranspositionTableSize * sizeof(TranspositionEntry));
+
+	// Fixed pseudo random keys for hashing the board (xorshift)
+	uint32 seed = 0x2545F491;
+	for (int i = 0; i < 49; i++) {
+		for (int j = 0; j < 5; j++) {
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			_zobristKeys[i][j] = seed;
+		}
+	}
 }
 
 byte CellGame::getStartX() {
@@ -72,6 +86,7 @@ byte CellGame::getEndY() {
 }
 
 CellGame::~CellGame() {
+	delete[] _transpositionTable;
 }
 
 const int8 possibleMoves[][9] = {
@@ -550,6 +565,44 @@ void CellGame::chooseBestMove(int8 color) {
 }
 
 int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
+	// Searching the last level is cheaper than hashing the board
+	if (depth < 2)
+		return searchBestWeight(color1, color2, depth, bestWeight);
+
+	// The search only looks at the board in _tempBoard and the parameters,
+	// so its result can be looked up if the position was seen before.
+	uint32 hash = ((uint32)color1 << 24) ^ ((uint32)color2 << 20) ^ ((uint32)_coeff3 << 16) ^ ((uint32)depth << 8) ^ (uint32)(bestWeight & 0xFF);
+	hash *= 0x9E3779B1;
+	for (int i = 0; i < 49; i++)
+		hash ^= _zobristKeys[i][_tempBoard[i]];
+
+	TranspositionEntry &entry = _transpositionTable[hash % kTranspositionTableSize];
+	if (entry.used && entry.hash == hash && entry.color1 == color1 && entry.color2 == color2 &&
+		entry.coeff3 == _coeff3 && entry.depth == depth && entry.bestWeight == bestWeight &&
+		!memcmp(entry.board, _tempBoard, 49))
+		return entry.weight;
+
+	int8 board[49];
+	memcpy(board, _tempBoard, 49);
+
+	int8 weight = searchBestWeight(color1, color2, depth, bestWeight);
+
+	// The entry may have been replaced by the search
+	TranspositionEntry &newEntry = _transpositionTable[hash % kTranspositionTableSize];
+	newEntry.hash = hash;
+	memcpy(newEntry.board, board, 49);
+	newEntry.color1 = color1;
+	newEntry.color2 = color2;
+	newEntry.coeff3 = _coeff3;
+	newEntry.depth = depth;
+	newEntry.bestWeight = bestWeight;
+	newEntry.weight = weight;
+	newEntry.used = true;
+
+	return weight;
+}
+
+int8 CellGame::searchBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
 	int8 res;
 	int8 curColor;
 	bool canMove;
@@ -66,6 +66,7 @@ private:
 	int getBoardWeight(int8 color1, int8 color2);
 	void chooseBestMove(int8 color);
 	int8 calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
+	int8 searchBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
 	int16 doGame(int8 color, int depth);
 	int16 calcMove(int8 color, uint16 depth);
 
@@ -90,6 +91,30 @@ private:
 	int _coeff3;
 	bool _flag1, _flag2, _flag4;
 	int _moveCount;
+
+	/**
+	 * Weight calculated by calcBestWeight() for a board. The weight only
+	 * depends on the board and the parameters, so it can be reused when the
+	 * same position is reached again by a different sequence of moves.
+	 */
+	struct TranspositionEntry {
+		uint32 hash;
+		int8 board[49];
+		int8 color1;
+		int8 color2;
+		int8 coeff3;
+		uint16 depth;
+		int16 bestWeight;
+		int8 weight;
+		bool used;
+	};
+
+	enum {
+		kTranspositionTableSize = 4096
+	};
+
+	TranspositionEntry *_transpositionTable;
+	uint32 _zobristKeys[49][5];
 };
 
 } // End of Groovie namespace
@@ -23,6 +23,8 @@
 #include "groovie/debug.h"
 #include "groovie/graphics.h"
 #include "groovie/groovie.h"
+#include "groovie/player.h"
+#include "groovie/resource.h"
 #include "groovie/script.h"
 
 #include "common/debug-channels.h"
@@ -46,6 +48,7 @@ Debugger::Debugger(GroovieEngine *vm) :
 	DCmd_Register("save", WRAP_METHOD(Debugger, cmd_savegame));
 	DCmd_Register("playref", WRAP_METHOD(Debugger, cmd_playref));
 	DCmd_Register("dumppal", WRAP_METHOD(Debugger, cmd_dumppal));
+	DCmd_Register("benchmark_video", WRAP_METHOD(Debugger, cmd_benchmarkvideo));
 }
 
 Debugger::~Debugger() {
@@ -145,4 +148,30 @@ bool Debugger::cmd_dumppal(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_benchmarkvideo(int argc, const char **argv) {
+	if (argc != 2) {
+		DebugPrintf("Syntax: benchmark_video <videorefnum>\n");
+		return true;
+	}
+
+	int ref = getNumber(argv[1]);
+	Common::SeekableReadStream *file = _vm->_resMan->open(ref);
+	if (!file) {
+		DebugPrintf("Couldn't open video %d\n", ref);
+		return true;
+	}
+
+	// The frames are decoded and shown like in the game, without waiting
+	uint32 millis;
+	uint32 frames = _vm->_videoPlayer->benchmark(file, 0, millis);
+	delete file;
+
+	if (!frames) {
+		DebugPrintf("Couldn't load video %d\n", ref);
+	} else {
+		DebugPrintf("Played %d frames in %d ms, %.2f ms per frame\n", frames, millis, (double)millis / frames);
+	}
+	return true;
+}
+
 } // End of Groovie namespace
@@ -28,7 +28,7 @@
 namespace Groovie {
 
 VideoPlayer::VideoPlayer(GroovieEngine *vm) :
-	_vm(vm), _syst(vm->_system), _file(NULL), _audioStream(NULL), _fps(0), _overrideSpeed(false) {
+	_vm(vm), _syst(vm->_system), _file(NULL), _audioStream(NULL), _fps(0), _overrideSpeed(false), _benchmarking(false) {
 }
 
 bool VideoPlayer::load(Common::SeekableReadStream *file, uint16 flags) {
@@ -86,7 +86,37 @@ bool VideoPlayer::playFrame() {
 	return end;
 }
 
+uint32 VideoPlayer::benchmark(Common::SeekableReadStream *file, uint16 flags, uint32 &millis) {
+	millis = 0;
+	if (!load(file, flags))
+		return 0;
+
+	_benchmarking = true;
+	uint32 frames = 0;
+	uint32 start = _syst->getMillis();
+	bool end = false;
+	while (!end) {
+		end = playFrameInternal();
+		frames++;
+	}
+	millis = _syst->getMillis() - start;
+	_benchmarking = false;
+
+	// Drop the audio decoded with the frames
+	if (_audioStream) {
+		_syst->getMixer()->stopHandle(_soundHandle);
+		_audioStream = NULL;
+	}
+	_file = NULL;
+
+	return frames;
+}
+
 void VideoPlayer::waitFrame() {
+	// Frames are shown as soon as possible when measuring the decoding
+	if (_benchmarking)
+		return;
+
 	uint32 currTime = _syst->getMillis();
 	if (!_begunPlaying) {
 		_begunPlaying = true;
@@ -25,6 +25,7 @@
 
 #include "common/system.h"
 #include "audio/audiostream.h"
+#include "audio/mixer.h"
 
 namespace Groovie {
 
@@ -37,6 +38,13 @@ public:
 
 	bool load(Common::SeekableReadStream *file, uint16 flags);
 	bool playFrame();
+
+	/**
+	 * Decode and show all frames of a video as fast as possible, without
+	 * its audio. Returns the number of frames, and the time it took.
+	 */
+	uint32 benchmark(Common::SeekableReadStream *file, uint16 flags, uint32 &millis);
+
 	virtual void resetFlags() {}
 	virtual void setOrigin(int16 x, int16 y) {}
 
@@ -53,12 +61,14 @@ protected:
 	Common::SeekableReadStream *_file;
 	uint16 _flags;
 	Audio::QueuingAudioStream *_audioStream;
+	Audio::SoundHandle _soundHandle;
 
 
 private:
 	// Synchronization stuff
 	bool _begunPlaying;
 	bool _overrideSpeed;
+	bool _benchmarking;
 	uint16 _fps;
 	uint16 _millisBetweenFrames;
 	uint32 _lastFrameTime;
@@ -33,10 +33,6 @@
 #include "graphics/palette.h"
 #include "graphics/decoders/jpeg.h"
 
-#ifdef USE_RGB_COLOR
-// Required for the YUV to RGB conversion
-#include "graphics/conversion.h"
-#endif
 #include "audio/mixer.h"
 #include "audio/decoders/raw.h"
 
@@ -44,12 +40,17 @@ namespace Groovie {
 
 ROQPlayer::ROQPlayer(GroovieEngine *vm) :
 	VideoPlayer(vm), _codingTypeCount(0),
-	_fg(&_vm->_graphicsMan->_foreground), _bg(&_vm->_graphicsMan->_background) {
+	_fg(&_vm->_graphicsMan->_foreground), _bg(&_vm->_graphicsMan->_background),
+	_frameNum(0), _blocksW(0), _blocksH(0), _currBlockFrames(0), _prevBlockFrames(0),
+	_showBlockFrames(0), _showColumns(0) {
 
 	// Create the work surfaces
 	_currBuf = new Graphics::Surface();
 	_prevBuf = new Graphics::Surface();
 
+	// No codebook entries have been read yet
+	memset(_codebook2Opaque, 0, sizeof(_codebook2Opaque));
+
 	if (_vm->_mode8bit) {
 		byte pal[256 * 3];
 
@@ -61,6 +62,23 @@ ROQPlayer::ROQPlayer(GroovieEngine *vm) :
 		}
 
 		_syst->getPaletteManager()->setPalette(pal, 0, 256);
+#ifdef USE_RGB_COLOR
+	} else {
+		// Split the conversion done by Graphics::YUV2RGB into the terms of
+		// each component, and the screen color into the bits of each channel
+		for (int i = 0; i < 256; i++) {
+			_yuvRV[i] = (1357 * (i - 128)) >> 10;
+			_yuvGU[i] = (333 * (i - 128)) >> 10;
+			_yuvGV[i] = (691 * (i - 128)) >> 10;
+			_yuvBU[i] = (1715 * (i - 128)) >> 10;
+		}
+		for (int i = 0; i < 768; i++) {
+			byte c = CLIP<int>(i - 256, 0, 255);
+			_colorR[i] = (uint16)_vm->_pixelFormat.RGBToColor(c, 0, 0);
+			_colorG[i] = (uint16)_vm->_pixelFormat.RGBToColor(0, c, 0);
+			_colorB[i] = (uint16)_vm->_pixelFormat.RGBToColor(0, 0, c);
+		}
+#endif // USE_RGB_COLOR
 	}
 }
 
@@ -70,6 +88,11 @@ ROQPlayer::~ROQPlayer() {
 	delete _currBuf;
 	_prevBuf->free();
 	delete _prevBuf;
+
+	delete[] _currBlockFrames;
+	delete[] _prevBlockFrames;
+	delete[] _showBlockFrames;
+	delete[] _showColumns;
 }
 
 uint16 ROQPlayer::loadInternal() {
@@ -90,6 +113,10 @@ uint16 ROQPlayer::loadInternal() {
 	// Clear the dirty flag
 	_dirty = true;
 
+	// The show buffer may have been changed since the last video
+	if (_showBlockFrames)
+		memset(_showBlockFrames, 0, _blocksW * _blocksH * sizeof(uint32));
+
 	// Reset the codebooks
 	_num2blocks = 0;
 	_num4blocks = 0;
@@ -112,33 +139,79 @@ uint16 ROQPlayer::loadInternal() {
 	}
 }
 
-void ROQPlayer::buildShowBuf() {
-	for (int line = 0; line < _bg->h; line++) {
-		byte *out = (byte *)_bg->getBasePtr(0, line);
-		byte *in = (byte *)_currBuf->getBasePtr(0, line / _scaleY);
-		for (int x = 0; x < _bg->w; x++) {
-			if (_vm->_mode8bit) {
-				// Just use the luminancy component
-				*out = *in;
-#ifdef USE_RGB_COLOR
-			} else {
-				// Do the format conversion (YUV -> RGB -> Screen format)
-				byte r, g, b;
-				Graphics::YUV2RGB(*in, *(in + 1), *(in + 2), r, g, b);
-				// FIXME: this is fixed to 16bit
-				*(uint16 *)out = (uint16)_vm->_pixelFormat.RGBToColor(r, g, b);
-#endif // USE_RGB_COLOR
+Common::Rect ROQPlayer::buildShowBuf() {
+	Common::Rect changed;
+
+	// Convert the runs of blocks which changed since they were last shown
+	for (int blockY = 0; blockY < _blocksH; blockY++) {
+		uint32 *curr = &_currBlockFrames[blockY * _blocksW];
+		uint32 *shown = &_showBlockFrames[blockY * _blocksW];
+
+		int blockX = 0;
+		while (blockX < _blocksW) {
+			if (curr[blockX] == shown[blockX]) {
+				blockX++;
+				continue;
+			}
+
+			int startX = blockX;
+			while (blockX < _blocksW && curr[blockX] != shown[blockX]) {
+				shown[blockX] = curr[blockX];
+				blockX++;
 			}
 
-			// Skip to the next pixel
-			out += _vm->_pixelFormat.bytesPerPixel;
-			if (!(x % _scaleX))
-				in += _currBuf->format.bytesPerPixel;
+			// Find the screen columns showing the pixels of these blocks
+			int left = MAX((startX * 4 - 1) * _scaleX + 1, 0);
+			int right = (blockX == _blocksW) ? _bg->w : (blockX * 4 - 1) * _scaleX + 1;
+			int top = blockY * 4 * _scaleY;
+			int bottom = MIN(blockY * 4 + 4, (int)_currBuf->h) * _scaleY;
+			Common::Rect area(left, top, MIN(right, (int)_bg->w), MIN(bottom, (int)_bg->h));
+			if (area.isEmpty())
+				continue;
+
+			convertToShowBuf(area);
+
+			if (changed.isEmpty())
+				changed = area;
+			else
+				changed.extend(area);
 		}
 	}
 
 	// Swap buffers
 	SWAP(_prevBuf, _currBuf);
+	SWAP(_prevBlockFrames, _currBlockFrames);
+
+	return changed;
+}
+
+void ROQPlayer::convertToShowBuf(const Common::Rect &area) {
+	const uint16 *columns = _showColumns + area.left;
+	const int width = area.width();
+
+	for (int line = area.top; line < area.bottom; line++) {
+		const byte *in = (const byte *)_currBuf->getBasePtr(0, line / _scaleY);
+
+		if (_vm->_mode8bit) {
+			// Just use the luminancy component
+			byte *out = (byte *)_bg->getBasePtr(area.left, line);
+			for (int x = 0; x < width; x++)
+				out[x] = in[columns[x]];
+#ifdef USE_RGB_COLOR
+		} else {
+			// FIXME: this is fixed to 16bit
+			uint16 *out = (uint16 *)_bg->getBasePtr(area.left, line);
+			for (int x = 0; x < width; x++) {
+				// Do the format conversion (YUV -> RGB -> Screen format)
+				const byte *pixel = in + columns[x];
+				const int y = pixel[0] + 256;
+				out[x] = _colorR[y + _yuvRV[pixel[2]]] |
+				         _colorG[y - _yuvGV[pixel[2]] - _yuvGU[pixel[1]]] |
+				         _colorB[y + _yuvBU[pixel[1]]];
+			}
+#endif // USE_RGB_COLOR
+		}
+	}
 }
 
 bool ROQPlayer::playFrameInternal() {
@@ -150,17 +223,21 @@ bool ROQPlayer::playFrameInternal() {
 		endframe = processBlock();
 	}
 
+	Common::Rect changed;
 	if (_dirty) {
 		// Build the show buffer from the current buffer
-		buildShowBuf();
+		changed = buildShowBuf();
 	}
 
 	// Wait until the current frame can be shown
 	waitFrame();
 
 	if (_dirty) {
-		// Update the screen
-		_syst->copyRectToScreen(_bg->getBasePtr(0, 0), _bg->pitch, 0, (_syst->getHeight() - _bg->h) / 2, _bg->w, _bg->h);
+		// Update the changed part of the screen
+		if (!changed.isEmpty()) {
+			_syst->copyRectToScreen(_bg->getBasePtr(changed.left, changed.top), _bg->pitch,
+				changed.left, (_syst->getHeight() - _bg->h) / 2 + changed.top, changed.width(), changed.height());
+		}
 		_syst->updateScreen();
 
 		// Clear the dirty flag
@@ -288,6 +365,23 @@ bool ROQPlayer::processBlockInfo(ROQBlockHeader &blockHeader) {
 		// them it should be just fine.
 		_currBuf->create(width, height, Graphics::PixelFormat(3, 0, 0, 0, 0, 0, 0, 0, 0));
 		_prevBuf->create(width, height, Graphics::PixelFormat(3, 0, 0, 0, 0, 0, 0, 0, 0));
+
+		// Reallocate the block frame numbers
+		delete[] _currBlockFrames;
+		delete[] _prevBlockFrames;
+		delete[] _showBlockFrames;
+		_blocksW = (width + 3) / 4;
+		_blocksH = (height + 3) / 4;
+		_currBlockFrames = new uint32[_blocksW * _blocksH];
+		_prevBlockFrames = new uint32[_blocksW * _blocksH];
+		_showBlockFrames = new uint32[_blocksW * _blocksH];
+		memset(_showBlockFrames, 0, _blocksW * _blocksH * sizeof(uint32));
+
+		// Calculate the offset of the pixel shown in each screen column
+		delete[] _showColumns;
+		_showColumns = new uint16[_bg->w];
+		for (int x = 0; x < _bg->w; x++)
+			_showColumns[x] = MIN((x + _scaleX - 1) / _scaleX, width - 1) * _currBuf->format.bytesPerPixel;
 	}
 
 	// Clear the buffers with black YUV values
@@ -302,6 +396,13 @@ bool ROQPlayer::processBlockInfo(ROQBlockHeader &blockHeader) {
 		*ptr2++ = 128;
 	}
 
+	// Both buffers have changed
+	_frameNum++;
+	for (int i = 0; i < _blocksW * _blocksH; i++) {
+		_currBlockFrames[i] = _frameNum;
+		_prevBlockFrames[i] = _frameNum;
+	}
+
 	return true;
 }
 
@@ -332,6 +433,24 @@ bool ROQPlayer::processBlockQuadCodebook(ROQBlockHeader &blockHeader) {
 
 		// Read the subsampled Cb and Cr
 		_file->read(&_codebook2[i * 10 + 8], 2);
+
+		// Expand the entry to pixel rows
+		byte *block = &_codebook2[i * 10];
+		_codebook2Opaque[i] = true;
+		for (int j = 0; j < 4; j++) {
+			byte *pixel = &_codebook2Pixels[i][j / 2][(j % 2) * 3];
+			pixel[0] = block[j * 2];
+			pixel[1] = block[8];
+			pixel[2] = block[9];
+
+			byte *scaled = &_codebook2Scaled[i][j / 2][(j % 2) * 6];
+			memcpy(scaled, pixel, 3);
+			memcpy(scaled + 3, pixel, 3);
+
+			// Basic alpha test
+			if (block[j * 2 + 1] <= 128)
+				_codebook2Opaque[i] = false;
+		}
 	}
 
 	// Read the 4x4 codebook
@@ -353,6 +472,9 @@ bool ROQPlayer::processBlockQuadVector(ROQBlockHeader &blockHeader) {
 	// Reset the coding types
 	_codingTypeCount = 0;
 
+	// Start a new frame for the changed blocks
+	_frameNum++;
+
 	// Traverse the image in 16x16 macroblocks
 	for (int macroY = 0; macroY < _currBuf->h; macroY += 16) {
 		for (int macroX = 0; macroX < _currBuf->w; macroX += 16) {
@@ -447,6 +569,11 @@ bool ROQPlayer::processBlockStill(ROQBlockHeader &blockHeader) {
 		*ptr++ = *v++;
 	}
 
+	// The whole frame has changed
+	_frameNum++;
+	for (int i = 0; i < _blocksW * _blocksH; i++)
+		_currBlockFrames[i] = _frameNum;
+
 	delete jpg;
 	return true;
 }
@@ -462,8 +589,7 @@ bool ROQPlayer::processBlockSoundMono(ROQBlockHeader &blockHeader) {
 	// Initialize the audio stream if needed
 	if (!_audioStream) {
 		_audioStream = Audio::makeQueuingAudioStream(22050, false);
-		Audio::SoundHandle sound_handle;
-		g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, &sound_handle, _audioStream);
+		g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, &_soundHandle, _audioStream);
 	}
 
 	// Create the audio buffer
@@ -505,8 +631,7 @@ bool ROQPlayer::processBlockSoundStereo(ROQBlockHeader &blockHeader) {
 	// Initialize the audio stream if needed
 	if (!_audioStream) {
 		_audioStream = Audio::makeQueuingAudioStream(22050, true);
-		Audio::SoundHandle sound_handle;
-		g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, &sound_handle, _audioStream);
+		g_system->getMixer()->playStream(Audio::Mixer::kPlainSoundType, &_soundHandle, _audioStream);
 	}
 
 	// Create the audio buffer
@@ -571,11 +696,19 @@ void ROQPlayer::paint2(byte i, int destx, int desty) {
 		error("Groovie::ROQ: Invalid 2x2 block %d (%d available)", i, _num2blocks);
 	}
 
+	setBlocksChanged(destx, desty, 2);
+
+	byte *ptr = (byte *)_currBuf->getBasePtr(destx, desty);
+	if (_codebook2Opaque[i]) {
+		memcpy(ptr, _codebook2Pixels[i][0], 6);
+		memcpy(ptr + _currBuf->pitch, _codebook2Pixels[i][1], 6);
+		return;
+	}
+
 	byte *block = &_codebook2[i * 10];
 	byte u = block[8];
 	byte v = block[9];
 
-	byte *ptr = (byte *)_currBuf->getBasePtr(destx, desty);
 	for (int y = 0; y < 2; y++) {
 		for (int x = 0; x < 2; x++) {
 			// Basic alpha test
@@ -611,25 +744,38 @@ void ROQPlayer::paint8(byte i, int destx, int desty) {
 		error("Groovie::ROQ: Invalid 4x4 block %d (%d available)", i, _num4blocks);
 	}
 
+	setBlocksChanged(destx, desty, 8);
+
+	const uint16 pitch = _currBuf->pitch;
 	byte *block4 = &_codebook4[i * 4];
 	for (int y4 = 0; y4 < 2; y4++) {
 		for (int x4 = 0; x4 < 2; x4++) {
-			byte *block2 = &_codebook2[(*block4) * 10];
+			byte *dst = (byte *)_currBuf->getBasePtr(destx + x4 * 4, desty + y4 * 4);
+			byte entry = *block4++;
+
+			if (_codebook2Opaque[entry]) {
+				// Each row of the entry covers two lines
+				for (int y2 = 0; y2 < 2; y2++) {
+					memcpy(dst, _codebook2Scaled[entry][y2], 12);
+					memcpy(dst + pitch, _codebook2Scaled[entry][y2], 12);
+					dst += 2 * pitch;
+				}
+				continue;
+			}
+
+			byte *block2 = &_codebook2[entry * 10];
 			byte u = block2[8];
 			byte v = block2[9];
-			block4++;
 			for (int y2 = 0; y2 < 2; y2++) {
 				for (int x2 = 0; x2 < 2; x2++) {
-					for (int repy = 0; repy < 2; repy++) {
-						for (int repx = 0; repx < 2; repx++) {
-							// Basic alpha test
-							// TODO: Blending
-							if (*(block2 + 1) > 128) {
-								byte *ptr = (byte *)_currBuf->getBasePtr(destx + x4*4 + x2*2 + repx, desty + y4*4 + y2*2 + repy);
-								*ptr = *block2;
-								*(ptr + 1) = u;
-								*(ptr + 2) = v;
-							}
+					// Basic alpha test
+					// TODO: Blending
+					if (*(block2 + 1) > 128) {
+						for (int repy = 0; repy < 2; repy++) {
+							byte *ptr = dst + (y2 * 2 + repy) * pitch + x2 * 6;
+							ptr[0] = ptr[3] = *block2;
+							ptr[1] = ptr[4] = u;
+							ptr[2] = ptr[5] = v;
 						}
 					}
 					block2 += 2;
@@ -655,6 +801,20 @@ void ROQPlayer::copy(byte size, int destx, int desty, int offx, int offy) {
 		dst += _currBuf->pitch;
 		src += _currBuf->pitch;
 	}
+
+	setBlocksChanged(destx, desty, size);
+}
+
+void ROQPlayer::setBlocksChanged(int destx, int desty, int size) {
+	int left = MAX(destx / 4, 0);
+	int right = MIN((destx + size + 3) / 4, (int)_blocksW);
+	int top = MAX(desty / 4, 0);
+	int bottom = MIN((desty + size + 3) / 4, (int)_blocksH);
+
+	for (int y = top; y < bottom; y++) {
+		for (int x = left; x < right; x++)
+			_currBlockFrames[y * _blocksW + x] = _frameNum;
+	}
 }
 
 } // End of Groovie namespace
@@ -25,6 +25,8 @@
 
 #include "groovie/player.h"
 
+#include "common/rect.h"
+
 namespace Groovie {
 
 class GroovieEngine;
@@ -62,6 +64,7 @@ private:
 	void paint4(byte i, int destx, int desty);
 	void paint8(byte i, int destx, int desty);
 	void copy(byte size, int destx, int desty, int offx, int offy);
+	void setBlocksChanged(int destx, int desty, int size);
 
 	// Block coding type
 	byte getCodingType();
@@ -74,15 +77,33 @@ private:
 	byte _codebook2[256 * 10];
 	byte _codebook4[256 * 4];
 
+	// 2x2 codebook entries expanded to YUV pixel rows, at normal size and
+	// scaled to 4x4 pixels. They are used when all four pixels are opaque.
+	byte _codebook2Pixels[256][2][6];
+	byte _codebook2Scaled[256][2][12];
+	bool _codebook2Opaque[256];
+
 	// Buffers
 	Graphics::Surface *_fg, *_bg, *_thirdBuf;
 	Graphics::Surface *_currBuf, *_prevBuf;
-	void buildShowBuf();
+	Common::Rect buildShowBuf();
+	void convertToShowBuf(const Common::Rect &area);
 	byte _scaleX, _scaleY;
 	byte _offScale;
 	bool _dirty;
 	byte _alpha;
 
+	// Number of the frame in which each 4x4 block of the buffers was last
+	// changed, so only changed blocks have to be converted for showing
+	uint32 _frameNum;
+	uint16 _blocksW, _blocksH;
+	uint32 *_currBlockFrames, *_prevBlockFrames, *_showBlockFrames;
+	uint16 *_showColumns;
+
+	// Lookup tables for the YUV to screen format conversion. The color
+	// tables are indexed by the unclipped component value plus 256.
+	int16 _yuvRV[256], _yuvGU[256], _yuvGV[256], _yuvBU[256];
+	uint16 _colorR[768], _colorG[768], _colorB[768];
 };
 
 } // End of Groovie namespace
@@ -50,6 +50,7 @@ void Debugger::initialize() {
 	DCmd_Register("queryflag",          WRAP_METHOD(Debugger, cmd_queryFlag));
 	DCmd_Register("timers",             WRAP_METHOD(Debugger, cmd_listTimers));
 	DCmd_Register("settimercountdown",  WRAP_METHOD(Debugger, cmd_setTimerCountdown));
+	DCmd_Register("benchmark_shapes",   WRAP_METHOD(Debugger, cmd_benchmarkShapes));
 }
 
 bool Debugger::cmd_setScreenDebug(int argc, const char **argv) {
@@ -197,6 +198,79 @@ bool Debugger::cmd_setTimerCountdown(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_benchmarkShapes(int argc, const char **argv) {
+	if (_vm->game() == GI_EOB1 || _vm->game() == GI_EOB2) {
+		DebugPrintf("Eye of the Beholder draws its shapes with its own code.\n");
+		return true;
+	}
+
+	const int count = (argc > 1) ? MAX(1, atoi(argv[1])) : 2000;
+	Screen *screen = _vm->screen();
+
+	// Cut a shape out of the current screen, and draw it to page 5 with the
+	// plot types used by the scenes, unscaled and scaled like distant
+	// monsters in LoL. Page 5 is restored afterwards.
+	uint8 *buffer = new uint8[320 * 200];
+	screen->copyRegionToBuffer(5, 0, 0, 320, 200, buffer);
+
+	// The plot types with 0x400 skip the color table of the shape, so
+	// they get a shape which has one
+	const int oldPage = screen->setCurPage(0);
+	uint8 *plainShape = screen->encodeShape(128, 68, 64, 64, 0);
+	uint8 *tableShape = screen->encodeShape(128, 68, 64, 64, 1);
+	screen->setCurPage(oldPage);
+
+	uint8 table[256], table2[256], table5[256];
+	for (int i = 0; i < 256; ++i) {
+		table[i] = i;
+		table2[i] = (i == 1) ? 255 : i;
+		table5[i] = 255 - i;
+	}
+
+	static const int plotTypes[] = { 0, 1, 3, 4, 5, 33, 37 };
+
+	DebugPrintf("Drawing a 64x64 shape %d times per plot type:\n", count);
+	for (int i = 0; i < ARRAYSIZE(plotTypes); ++i) {
+		const int type = plotTypes[i];
+		// Kyra 1 does not pass the table these plot types need
+		if (_vm->game() == GI_KYRA1 && type >= 32)
+			continue;
+
+		const uint8 *shape = (type & 4) ? tableShape : plainShape;
+		uint32 times[2];
+		for (int scaled = 0; scaled < 2; ++scaled) {
+			const int flags = (type << 8) | 0x8000 | (scaled ? (int)Screen::DSF_SCALE : 0);
+			const uint32 start = _vm->_system->getMillis();
+
+			for (int n = 0; n < count; ++n) {
+				const int x = (n * 37) % 256;
+				const int y = (n * 23) % 136;
+				// drawShape() only reads the arguments for the flags which
+				// are set, in this order
+				if (scaled && (type & 1))
+					screen->drawShape(5, shape, x, y, 0, flags, table2, table, 1, 0x90, 0xA0, table5);
+				else if (scaled)
+					screen->drawShape(5, shape, x, y, 0, flags, table2, 0x90, 0xA0, table5);
+				else if (type & 1)
+					screen->drawShape(5, shape, x, y, 0, flags, table2, table, 1, table5);
+				else
+					screen->drawShape(5, shape, x, y, 0, flags, table2, table5);
+			}
+
+			times[scaled] = _vm->_system->getMillis() - start;
+		}
+
+		DebugPrintf("plot type %2d: %5u ms, scaled %5u ms\n", type, times[0], times[1]);
+	}
+
+	delete[] plainShape;
+	delete[] tableShape;
+	screen->copyBlockToPage(5, 0, 0, 320, 200, buffer);
+	delete[] buffer;
+
+	return true;
+}
+
 #pragma mark -
 
 Debugger_LoK::Debugger_LoK(KyraEngine_LoK *vm)
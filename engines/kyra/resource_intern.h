@@ -51,6 +51,7 @@ public:
 	// Common::Archive API implementation
 	bool hasFile(const Common::String &name) const;
 	int listMembers(Common::ArchiveMemberList &list) const;
+	bool listsAllMembers() const { return true; }
 	const Common::ArchiveMemberPtr getMember(const Common::String &name) const;
 	Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const;
 private:
@@ -65,6 +66,8 @@ public:
 	TlkArchive(Common::ArchiveMemberPtr file, uint16 entryCount, const uint32 *fileEntries);
 	~TlkArchive();
 
+	// Files are looked up by their number, whatever the name is formatted
+	// like, so listMembers() cannot list all names hasFile() accepts.
 	bool hasFile(const Common::String &name) const;
 	int listMembers(Common::ArchiveMemberList &list) const;
 	const Common::ArchiveMemberPtr getMember(const Common::String &name) const;
@@ -94,6 +97,7 @@ public:
 
 	bool hasFile(const Common::String &name) const;
 	int listMembers(Common::ArchiveMemberList &list) const;
+	bool listsAllMembers() const { return true; }
 	const Common::ArchiveMemberPtr getMember(const Common::String &name) const;
 	Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const;
 private:
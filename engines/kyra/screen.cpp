@@ -1455,17 +1455,6 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 		&Screen::drawShapeSkipScaleDownwind
 	};
 
-	static const DsLineFunc dsLineFunc[] = {
-		&Screen::drawShapeProcessLineNoScaleUpwind,
-		&Screen::drawShapeProcessLineNoScaleDownwind,
-		&Screen::drawShapeProcessLineNoScaleUpwind,
-		&Screen::drawShapeProcessLineNoScaleDownwind,
-		&Screen::drawShapeProcessLineScaleUpwind,
-		&Screen::drawShapeProcessLineScaleDownwind,
-		&Screen::drawShapeProcessLineScaleUpwind,
-		&Screen::drawShapeProcessLineScaleDownwind
-	};
-
 	static const DsPlotFunc dsPlotFunc[] = {
 		&Screen::drawShapePlotType0,		// used by Kyra 1 + 2
 		&Screen::drawShapePlotType1,		// used by Kyra 3
@@ -1505,22 +1494,26 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 	const int drawFunc = flags & 0x0F;
 	_dsProcessMargin = dsMarginFunc[drawFunc];
 	_dsScaleSkip = dsSkipFunc[drawFunc];
-	_dsProcessLine = dsLineFunc[drawFunc];
 
 	const int ppc = (flags >> 8) & 0x3F;
+	const int ppc3 = (flags & 0x800) ? (((flags >> 8) & 0xF7) & 0x3F) : ppc;
 	_dsPlot = dsPlotFunc[ppc];
-	DsPlotFunc dsPlot2 = dsPlotFunc[ppc], dsPlot3 = dsPlotFunc[ppc];
-	if (flags & 0x800)
-		dsPlot3 = dsPlotFunc[((flags >> 8) & 0xF7) & 0x3F];
+	DsPlotFunc dsPlot2 = dsPlotFunc[ppc], dsPlot3 = dsPlotFunc[ppc3];
 
 	if (!_dsPlot || !dsPlot2 || !dsPlot3) {
 		if (!dsPlot2)
 			warning("Missing drawShape plotting method type %d", ppc);
 		if (dsPlot3 != dsPlot2 && !dsPlot3)
-			warning("Missing drawShape plotting method type %d", (((flags >> 8) & 0xF7) & 0x3F));
+			warning("Missing drawShape plotting method type %d", ppc3);
 		return;
 	}
 
+	// Select the line functions for both plot types once per shape, instead
+	// of calling the plot function indirectly for every pixel
+	DsLineFunc dsLine2 = getDrawShapeLineFunc(drawFunc, ppc);
+	DsLineFunc dsLine3 = getDrawShapeLineFunc(drawFunc, ppc3);
+	_dsProcessLine = dsLine2;
+
 	int curY = y;
 	const uint8 *src = shapeData;
 	uint8 *dst = _dsDstPage = getPagePtr(pageNum);
@@ -1700,6 +1693,7 @@ void Screen::drawShape(uint8 pageNum, const uint8 *shapeData, int x, int y, int
 					if (flags & 0x800)
 						normalPlot = (curY > _maskMinY && curY < _maskMaxY);
 					_dsPlot = normalPlot ? dsPlot2 : dsPlot3;
+					_dsProcessLine = normalPlot ? dsLine2 : dsLine3;
 					(this->*_dsProcessLine)(d, src, cnt, scaleState);
 				}
 				cnt += _dsOffscreenRight;
@@ -1828,12 +1822,13 @@ int Screen::drawShapeSkipScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt)
 	return found ? 0 : _dsOffscreenScaleVal1;
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineNoScaleUpwind(uint8 *&dst, const uint8 *&src, int &cnt, int16) {
 	do {
 		uint8 c = *src++;
 		if (c) {
 			uint8 *d = dst++;
-			(this->*_dsPlot)(d, c);
+			(this->*plot)(d, c);
 			cnt--;
 		} else {
 			c = *src++;
@@ -1843,12 +1838,13 @@ void Screen::drawShapeProcessLineNoScaleUpwind(uint8 *&dst, const uint8 *&src, i
 	} while (cnt > 0);
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineNoScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt, int16) {
 	do {
 		uint8 c = *src++;
 		if (c) {
 			uint8 *d = dst--;
-			(this->*_dsPlot)(d, c);
+			(this->*plot)(d, c);
 			cnt--;
 		} else {
 			c = *src++;
@@ -1858,6 +1854,7 @@ void Screen::drawShapeProcessLineNoScaleDownwind(uint8 *&dst, const uint8 *&src,
 	} while (cnt > 0);
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState) {
 	int c = 0;
 
@@ -1877,7 +1874,7 @@ void Screen::drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int
 				scaleState = r & 0xFF;
 			}
 		} else if (scaleState) {
-			(this->*_dsPlot)(dst++, c);
+			(this->*plot)(dst++, c);
 			scaleState -= 0x100;
 			cnt--;
 		}
@@ -1886,6 +1883,7 @@ void Screen::drawShapeProcessLineScaleUpwind(uint8 *&dst, const uint8 *&src, int
 	cnt = -1;
 }
 
+template<Screen::DsPlotFunc plot>
 void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, int &cnt, int16 scaleState) {
 	int c = 0;
 
@@ -1905,7 +1903,7 @@ void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, i
 				scaleState = r & 0xFF;
 			}
 		} else {
-			(this->*_dsPlot)(dst--, c);
+			(this->*plot)(dst--, c);
 			scaleState -= 0x100;
 			cnt--;
 		}
@@ -1914,6 +1912,49 @@ void Screen::drawShapeProcessLineScaleDownwind(uint8 *&dst, const uint8 *&src, i
 	cnt = -1;
 }
 
+#define DS_LINE_FUNCS(plot) { \
+		&Screen::drawShapeProcessLineNoScaleUpwind<plot>, \
+		&Screen::drawShapeProcessLineNoScaleDownwind<plot>, \
+		&Screen::drawShapeProcessLineScaleUpwind<plot>, \
+		&Screen::drawShapeProcessLineScaleDownwind<plot> \
+	}
+
+Screen::DsLineFunc Screen::getDrawShapeLineFunc(int drawFunc, int plotType) {
+	struct LineFuncs {
+		int plotType;
+		DsLineFunc funcs[4];
+	};
+
+	static const LineFuncs lineFuncs[] = {
+		{  0, DS_LINE_FUNCS(&Screen::drawShapePlotType0) },
+		{  1, DS_LINE_FUNCS(&Screen::drawShapePlotType1) },
+		{  4, DS_LINE_FUNCS(&Screen::drawShapePlotType4) },
+		{  5, DS_LINE_FUNCS(&Screen::drawShapePlotType5) },
+		{  8, DS_LINE_FUNCS(&Screen::drawShapePlotType8) },
+		{  9, DS_LINE_FUNCS(&Screen::drawShapePlotType9) },
+		{ 12, DS_LINE_FUNCS(&Screen::drawShapePlotType12) },
+		{ 13, DS_LINE_FUNCS(&Screen::drawShapePlotType13) },
+		{ 33, DS_LINE_FUNCS(&Screen::drawShapePlotType33) },
+		{ 37, DS_LINE_FUNCS(&Screen::drawShapePlotType37) },
+		{ -1, DS_LINE_FUNCS(&Screen::drawShapePlotIndirect) }
+	};
+
+	// Bit 0 selects drawing downwind, bit 2 scaling
+	const int variant = (drawFunc & 1) | ((drawFunc & 4) >> 1);
+
+	int i = 0;
+	while (lineFuncs[i].plotType != -1 && lineFuncs[i].plotType != plotType)
+		++i;
+
+	return lineFuncs[i].funcs[variant];
+}
+
+#undef DS_LINE_FUNCS
+
+void Screen::drawShapePlotIndirect(uint8 *dst, uint8 cmd) {
+	(this->*_dsPlot)(dst, cmd);
+}
+
 void Screen::drawShapePlotType0(uint8 *dst, uint8 cmd) {
 	*dst = cmd;
 }
@@ -22,6 +22,7 @@
 
 // Resource library
 
+#include "common/bufferedstream.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
@@ -1594,6 +1595,8 @@ int ResourceManager::readResourceMapSCI0(ResourceSource *map) {
 		fileStream = file;
 	}
 
+	// The map is read entry by entry
+	fileStream = Common::wrapBufferedSeekableReadStream(fileStream, 4096, DisposeAfterUse::YES);
 	fileStream->seek(0, SEEK_SET);
 
 	byte bMask = (_mapVersion >= kResVersionSci1Middle) ? 0xF0 : 0xFC;
@@ -1662,6 +1665,10 @@ int ResourceManager::readResourceMapSCI1(ResourceSource *map) {
 		fileStream = file;
 	}
 
+	// The map is read entry by entry, jumping between the blocks of the
+	// resource types
+	fileStream = Common::wrapBufferedSeekableReadStream(fileStream, 4096, DisposeAfterUse::YES);
+
 	resource_index_t resMap[32];
 	memset(resMap, 0, sizeof(resource_index_t) * 32);
 	byte type = 0, prevtype = 0;
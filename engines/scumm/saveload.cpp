@@ -177,7 +177,7 @@ bool ScummEngine::saveState(Common::OutSaveFile *out, bool writeHeader) {
 	return true;
 }
 
-bool ScummEngine::saveState(int slot, bool compat) {
+bool ScummEngine::saveState(int slot, bool compat, bool autosave) {
 	bool saveFailed;
 	Common::String filename;
 	Common::OutSaveFile *out;
@@ -190,7 +190,18 @@ bool ScummEngine::saveState(int slot, bool compat) {
 	} else {
 		filename = makeSavegameName(slot, compat);
 	}
-	if (!(out = _saveFileMan->openForSaving(filename)))
+
+	// Autosaves are written in the background, so that the game does not
+	// freeze while the savegame is compressed. Other saves, including those
+	// requested by scripts, are written directly, so that errors can be
+	// reported to the user.
+	const uint32 saveStart = _system->getMillis();
+
+	if (autosave)
+		out = _saveFileMan->openForSavingInBackground(filename);
+	else
+		out = _saveFileMan->openForSaving(filename);
+	if (!out)
 		return false;
 
 	saveFailed = false;
@@ -206,7 +217,10 @@ bool ScummEngine::saveState(int slot, bool compat) {
 		debug(1, "State save as '%s' FAILED", filename.c_str());
 		return false;
 	}
-	debug(1, "State saved as '%s'", filename.c_str());
+	if (autosave)
+		debug(1, "State saved as '%s', game stalled for %d ms", filename.c_str(), _system->getMillis() - saveStart);
+	else
+		debug(1, "State saved as '%s'", filename.c_str());
 
 	pauseEngine(false);
 
@@ -1825,6 +1839,25 @@ void Serializer::saveArrayOf(void *b, int len, int datasize, byte filetype) {
 		return;
 	}
 
+	// speed up word and dword arrays by converting them in blocks
+	if ((datasize == 2 && (filetype == sleUint16 || filetype == sleInt16)) ||
+		(datasize == 4 && (filetype == sleUint32 || filetype == sleInt32))) {
+		byte buffer[1024];
+		const int count = sizeof(buffer) / datasize;
+		while (len > 0) {
+			const int n = MIN(len, count);
+			for (int i = 0; i < n; i++, at += datasize) {
+				if (datasize == 2)
+					WRITE_LE_UINT16(buffer + 2 * i, *(uint16 *)at);
+				else
+					WRITE_LE_UINT32(buffer + 4 * i, *(uint32 *)at);
+			}
+			saveBytes(buffer, n * datasize);
+			len -= n;
+		}
+		return;
+	}
+
 	while (--len >= 0) {
 		if (datasize == 0) {
 			// Do nothing for obsolete data
@@ -21,6 +21,7 @@
  */
 
 #include "common/config-manager.h"
+#include "common/profiler.h"
 #include "common/util.h"
 #include "common/system.h"
 
@@ -458,6 +459,7 @@ void ScummEngine::refreshScriptPointer() {
 
 /** Execute a script - Read opcode, and execute it from the table */
 void ScummEngine::executeScript() {
+	Common::ProfileScope profile(Common::kProfileScript);
 	int c;
 	while (_currentScript != 0xFF) {
 
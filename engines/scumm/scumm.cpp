@@ -23,6 +23,7 @@
 #include "common/config-manager.h"
 #include "common/debug-channels.h"
 #include "common/md5.h"
+#include "common/profiler.h"
 #include "common/events.h"
 #include "common/system.h"
 #include "common/translation.h"
@@ -224,6 +225,7 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 	_saveLoadSlot = 0;
 	_lastSaveTime = 0;
 	_saveTemporaryState = false;
+	_saveLoadAutosave = false;
 	memset(_localScriptOffsets, 0, sizeof(_localScriptOffsets));
 	_scriptPointer = NULL;
 	_scriptOrgPointer = NULL;
@@ -590,6 +592,9 @@ ScummEngine::ScummEngine(OSystem *syst, const DetectorResult &dr)
 
 
 ScummEngine::~ScummEngine() {
+	// Write any pending autosave, see saveState()
+	_saveFileMan->finishBackgroundSaves();
+
 	DebugMan.clearAllDebugChannels();
 
 	delete _musicEngine;
@@ -2183,6 +2188,7 @@ void ScummEngine::scummLoop(int delta) {
 		_saveLoadDescription = Common::String::format("Autosave %d", _saveLoadSlot);
 		_saveLoadFlag = 1;
 		_saveTemporaryState = false;
+		_saveLoadAutosave = true;
 	}
 
 	if (VAR_GAME_LOADED != 0xFF)
@@ -2250,6 +2256,7 @@ load_game:
 	if (_currentRoom == 0) {
 		if (_game.version > 3)
 			CHARSET_1();
+		Common::ProfileScope profile(Common::kProfileGraphics);
 		drawDirtyScreenParts();
 	} else {
 		walkActors();
@@ -2258,9 +2265,11 @@ load_game:
 		if (_game.version > 3)
 			CHARSET_1();
 
-		scummLoop_handleDrawing();
-
-		scummLoop_handleActors();
+		{
+			Common::ProfileScope profile(Common::kProfileGraphics);
+			scummLoop_handleDrawing();
+			scummLoop_handleActors();
+		}
 
 		_fullRedraw = false;
 
@@ -2274,8 +2283,11 @@ load_game:
 		handleMouseOver(oldEgo != VAR(VAR_EGO));
 
 		// Render everything to the screen.
-		updatePalette();
-		drawDirtyScreenParts();
+		{
+			Common::ProfileScope profile(Common::kProfileGraphics);
+			updatePalette();
+			drawDirtyScreenParts();
+		}
 
 		// FIXME / TODO: Try to move the following to scummLoop_handleSound or
 		// scummLoop_handleActors (but watch out for regressions!)
@@ -2370,7 +2382,7 @@ void ScummEngine::scummLoop_handleSaveLoad() {
 			VAR(VAR_GAME_LOADED) = 0;
 
 		if (_saveLoadFlag == 1) {
-			success = saveState(_saveLoadSlot, _saveTemporaryState);
+			success = saveState(_saveLoadSlot, _saveTemporaryState, _saveLoadAutosave);
 			if (!success)
 				errMsg = _("Failed to save game state to file:\n\n%s");
 
@@ -2400,6 +2412,7 @@ void ScummEngine::scummLoop_handleSaveLoad() {
 			clearClickedStatus();
 
 		_saveLoadFlag = 0;
+		_saveLoadAutosave = false;
 		_lastSaveTime = _system->getMillis();
 	}
 }
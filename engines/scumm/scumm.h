@@ -593,11 +593,12 @@ protected:
 	byte _saveLoadFlag, _saveLoadSlot;
 	uint32 _lastSaveTime;
 	bool _saveTemporaryState;
+	bool _saveLoadAutosave;	// Set only when the autosave timer requested the save
 	Common::String _saveLoadFileName;
 	Common::String _saveLoadDescription;
 
 	bool saveState(Common::OutSaveFile *out, bool writeHeader = true);
-	bool saveState(int slot, bool compat);
+	bool saveState(int slot, bool compat, bool autosave = false);
 	bool loadState(int slot, bool compat);
 	virtual void saveOrLoad(Serializer *s);
 	void saveResource(Serializer *ser, ResType type, ResId idx);
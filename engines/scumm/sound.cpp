@@ -43,6 +43,7 @@
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
 #include "audio/decoders/mp3.h"
+#include "audio/decoders/pcmcache.h"
 #include "audio/decoders/raw.h"
 #include "audio/decoders/voc.h"
 #include "audio/decoders/vorbis.h"
@@ -95,6 +96,10 @@ Sound::~Sound() {
 	stopCDTimer();
 	g_system->getAudioCDManager()->stop();
 	free(_offsetTable);
+
+	// Cached speech is keyed by file name only, so make sure it does not
+	// leak into the next game.
+	PCMCacheMan.clear();
 }
 
 void Sound::addSoundToQueue(int sound, int heOffset, int heChannel, int heFlags) {
@@ -563,6 +568,11 @@ void Sound::startTalkSound(uint32 offset, uint32 b, int mode, Audio::SoundHandle
 			}
 			offset = result->new_offset;
 			size = result->compressed_size;
+
+			// Speech lines of a conversation are mostly stored one after
+			// another, so decode the following line while this one plays.
+			if (result + 1 < _offsetTable + _numSoundEffects)
+				prefetchTalkSound(result + 1);
 		} else {
 			offset += 8;
 			size = -1;
@@ -604,28 +614,13 @@ void Sound::startTalkSound(uint32 offset, uint32 b, int mode, Audio::SoundHandle
 
 		switch (_soundMode) {
 		case kMP3Mode:
-#ifdef USE_MAD
-			{
-			assert(size > 0);
-			input = Audio::makeMP3Stream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
-			}
-#endif
-			break;
 		case kVorbisMode:
-#ifdef USE_VORBIS
-			{
-			assert(size > 0);
-			input = Audio::makeVorbisStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
-			}
-#endif
-			break;
 		case kFLACMode:
-#ifdef USE_FLAC
-			{
 			assert(size > 0);
-			input = Audio::makeFLACStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
-			}
-#endif
+			// Only set up a decoder if the sound is not cached
+			input = PCMCacheMan.getStream(_sfxFilename, offset, size);
+			if (!input)
+				input = PCMCacheMan.makeStream(_sfxFilename, offset, size, makeCompressedStream(file.release(), offset, size));
 			break;
 		default:
 			input = Audio::makeVOCStream(file.release(), Audio::FLAG_UNSIGNED, DisposeAfterUse::YES);
@@ -648,6 +643,59 @@ void Sound::startTalkSound(uint32 offset, uint32 b, int mode, Audio::SoundHandle
 	}
 }
 
+static Audio::PCMCache::DecoderFactory getCompressedStreamFactory(Sound::SoundMode soundMode) {
+	switch (soundMode) {
+	case Sound::kMP3Mode:
+#ifdef USE_MAD
+		return &Audio::makeMP3Stream;
+#endif
+		break;
+	case Sound::kVorbisMode:
+#ifdef USE_VORBIS
+		return &Audio::makeVorbisStream;
+#endif
+		break;
+	case Sound::kFLACMode:
+#ifdef USE_FLAC
+		return &Audio::makeFLACStream;
+#endif
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+Audio::SeekableAudioStream *Sound::makeCompressedStream(Common::SeekableReadStream *file, uint32 offset, uint32 size) {
+	Common::SeekableReadStream *stream = new Common::SeekableSubReadStream(file, offset, offset + size, DisposeAfterUse::YES);
+
+	Audio::PCMCache::DecoderFactory factory = getCompressedStreamFactory(_soundMode);
+	if (factory)
+		return factory(stream, DisposeAfterUse::YES);
+
+	delete stream;
+	return 0;
+}
+
+void Sound::prefetchTalkSound(const MP3OffsetTable *entry) {
+	const uint32 offset = entry->new_offset + entry->num_tags * 2;
+	if (!PCMCacheMan.needsPrefetch(_sfxFilename, offset, entry->compressed_size))
+		return;
+
+	ScummFile *file = new ScummFile();
+	if (!_vm->openFile(*file, _sfxFilename)) {
+		delete file;
+		return;
+	}
+	file->setEnc(_sfxFileEncByte);
+
+	// The decoder is created by the cache's timer, since the MP3 decoder
+	// reads through the whole sound to index its frames.
+	Common::SeekableReadStream *stream = new Common::SeekableSubReadStream(file, offset, offset + entry->compressed_size, DisposeAfterUse::YES);
+	PCMCacheMan.prefetch(_sfxFilename, offset, entry->compressed_size, stream, getCompressedStreamFactory(_soundMode));
+}
+
 void Sound::stopTalkSound() {
 	if (_sfxMode & 2) {
 		if (_vm->_imuseDigital) {
@@ -133,6 +133,9 @@ protected:
 
 	bool isSoundInQueue(int sound) const;
 
+	Audio::SeekableAudioStream *makeCompressedStream(Common::SeekableReadStream *file, uint32 offset, uint32 size);
+	void prefetchTalkSound(const MP3OffsetTable *entry);
+
 	virtual void processSoundQueues();
 };
 
@@ -22,14 +22,78 @@
 
 #include "sword25/console.h"
 #include "sword25/sword25.h"
+#include "sword25/gfx/image/vectorimage.h"
+#include "sword25/kernel/kernel.h"
+#include "sword25/package/packagemanager.h"
+
+#include "common/archive.h"
+#include "common/system.h"
 
 namespace Sword25 {
 
 Sword25Console::Sword25Console(Sword25Engine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+	DCmd_Register("benchmark_vectors", WRAP_METHOD(Sword25Console, Cmd_BenchmarkVectors));
 }
 
 Sword25Console::~Sword25Console() {
 }
 
+/**
+ * Render all vector images of the game at their original size, and scaled
+ * down and up, and print how long this took.
+ */
+bool Sword25Console::Cmd_BenchmarkVectors(int argc, const char **argv) {
+	static const float scales[] = { 1.0f, 0.5f, 2.0f };
+
+	PackageManager *package = Kernel::getInstance()->getPackage();
+
+	// Wildcards do not match path separators, so search each directory depth
+	Common::ArchiveMemberList files;
+	Common::String pattern = "/*.swf";
+	for (int depth = 0; depth < 6; depth++) {
+		package->doSearch(files, pattern, "", PackageManager::FT_FILE);
+		pattern = "/*" + pattern;
+	}
+
+	uint imageCount = 0;
+	uint renderCount = 0;
+	uint64 pixelCount = 0;
+	uint32 renderTime = 0;
+
+	for (Common::ArchiveMemberList::const_iterator i = files.begin(); i != files.end(); ++i) {
+		const Common::String fileName = "/" + (*i)->getName();
+		uint fileSize;
+		byte *fileData = package->getFile(fileName, &fileSize);
+		if (!fileData)
+			continue;
+
+		bool success;
+		VectorImage image(fileData, fileSize, success, fileName);
+		delete[] fileData;
+		if (!success || image.getWidth() <= 0 || image.getHeight() <= 0)
+			continue;
+
+		imageCount++;
+		for (uint s = 0; s < ARRAYSIZE(scales); s++) {
+			const int width = MAX((int)(image.getWidth() * scales[s]), 1);
+			const int height = MAX((int)(image.getHeight() * scales[s]), 1);
+
+			const uint32 start = g_system->getMillis();
+			free(image.render(width, height));
+			renderTime += g_system->getMillis() - start;
+
+			renderCount++;
+			pixelCount += width * height;
+		}
+	}
+
+	DebugPrintf("Rendered %d vector images %d times, %d megapixels in %d ms\n",
+	            imageCount, renderCount, (int)(pixelCount / 1000000), renderTime);
+	if (renderCount > 0)
+		DebugPrintf("%.2f ms per rendering\n", (double)renderTime / renderCount);
+	return true;
+}
+
 } // End of namespace Sword25
@@ -60,6 +60,11 @@ public:
 					_pImage(pImage), Resource(filename, Resource::TYPE_BITMAP) {}
 	virtual ~BitmapResource() { delete _pImage; }
 
+	virtual uint getMemorySize() const {
+		// Images are stored as 32 bit pixels
+		return _pImage ? _pImage->getWidth() * _pImage->getHeight() * 4 : Resource::getMemorySize();
+	}
+
 	/**
 	    @brief Gibt zurck, ob das Objekt einen gltigen Zustand hat.
 	*/
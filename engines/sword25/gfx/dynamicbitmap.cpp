@@ -115,7 +115,8 @@ bool DynamicBitmap::doRender(RectangleList *updateRects) {
 }
 
 bool DynamicBitmap::setContent(const byte *pixeldata, uint size, uint offset, uint stride) {
-	++_version; // Update version to display the new video image
+	// The new video image has to be drawn, even if the object did not move
+	forceRefresh();
 	return _image->setContent(pixeldata, size, offset, stride);
 }
 
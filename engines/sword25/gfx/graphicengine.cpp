@@ -38,6 +38,7 @@
 #include "sword25/gfx/panel.h"
 #include "sword25/gfx/renderobjectmanager.h"
 #include "sword25/gfx/screenshot.h"
+#include "sword25/gfx/image/imageprefetcher.h"
 #include "sword25/gfx/image/renderedimage.h"
 #include "sword25/gfx/image/swimage.h"
 #include "sword25/gfx/image/vectorimage.h"
@@ -73,6 +74,7 @@ GraphicEngine::GraphicEngine(Kernel *pKernel) :
 	_thumbnail(NULL),
 	ResourceService(pKernel) {
 	_frameTimeSamples.resize(FRAMETIME_SAMPLE_COUNT);
+	_imagePrefetcher.reset(new ImagePrefetcher());
 
 	if (!registerScriptBindings())
 		error("Script bindings could not be registered.");
@@ -341,6 +343,19 @@ bool GraphicEngine::canLoadResource(const Common::String &filename) {
 		filename.hasPrefix("/saves");
 }
 
+bool GraphicEngine::prefetchResource(const Common::String &filename) {
+	// Only sprite images are decoded in the background. Software buffers
+	// and savegame thumbnails are rarely loaded.
+	if (!filename.hasSuffix(".png") || filename.hasSuffix("_s.png"))
+		return false;
+
+	return _imagePrefetcher->prefetch(filename);
+}
+
+bool GraphicEngine::takePrefetchedImage(const Common::String &fileName, byte *&pUncompressedData, int &width, int &height, int &pitch) {
+	return _imagePrefetcher->take(fileName, pUncompressedData, width, height, pitch);
+}
+
 void  GraphicEngine::updateLastFrameDuration() {
 	// Record current time
 	const uint currentTime = Kernel::getInstance()->getMilliTicks();
@@ -56,6 +56,7 @@ namespace Sword25 {
 
 class Kernel;
 class Image;
+class ImagePrefetcher;
 class Panel;
 class Screenshot;
 class RenderObjectManager;
@@ -274,6 +275,14 @@ public:
 	// --------------------------
 	virtual Resource *loadResource(const Common::String &fileName);
 	virtual bool canLoadResource(const Common::String &fileName);
+	virtual bool prefetchResource(const Common::String &fileName);
+
+	/**
+	 * Return the decoded data of an image prefetched through
+	 * prefetchResource(), like ImgLoader::decodePNGImage does.
+	 * @return false if the image was not prefetched
+	 */
+	bool takePrefetchedImage(const Common::String &fileName, byte *&pUncompressedData, int &width, int &height, int &pitch);
 
 	// Persistence Methods
 	// -------------------
@@ -316,6 +325,8 @@ private:
 
 	Common::ScopedPtr<RenderObjectManager> _renderObjectManagerPtr;
 
+	Common::ScopedPtr<ImagePrefetcher> _imagePrefetcher;
+
 	struct DebugLine {
 		DebugLine(const Vertex &start, const Vertex &end, uint color) :
 			_start(start),
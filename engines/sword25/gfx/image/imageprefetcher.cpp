@@ -0,0 +1,227 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/endian.h"
+#include "common/system.h"
+#include "common/timer.h"
+#include "sword25/kernel/kernel.h"
+#include "sword25/package/packagemanager.h"
+#include "sword25/gfx/image/imageprefetcher.h"
+#include "sword25/gfx/image/imgloader.h"
+
+namespace Sword25 {
+
+ImagePrefetcher::ImagePrefetcher() : _decodedSize(0), _timerInstalled(false) {
+}
+
+ImagePrefetcher::~ImagePrefetcher() {
+	// The timer proc may be removing itself right now, so remove it
+	// regardless of _timerInstalled, which does nothing if it is gone. The
+	// timer manager holds its lock while calling timerProc, so no image is
+	// being decoded anymore once the proc has been removed.
+	if (g_system->getTimerManager())
+		g_system->getTimerManager()->removeTimerProc(&timerProc);
+	clear();
+}
+
+bool ImagePrefetcher::prefetch(const Common::String &fileName) {
+	{
+		Common::StackLock lock(_mutex);
+		if (findJob(fileName) != _jobs.end())
+			return false;
+	}
+
+	PackageManager *pPackage = Kernel::getInstance()->getPackage();
+	assert(pPackage);
+
+	uint fileSize;
+	byte *fileData = pPackage->getFile(fileName, &fileSize);
+	if (!fileData)
+		return false;
+
+	Job *job = new Job();
+	job->fileName = fileName;
+	job->fileData = fileData;
+	job->fileSize = fileSize;
+	// The width and height are stored in the IHDR chunk, which follows the
+	// 8 byte signature.
+	job->decodedSize = (fileSize >= 24) ? READ_BE_UINT32(fileData + 16) * READ_BE_UINT32(fileData + 20) * 4 : 0;
+	job->data = 0;
+	job->width = job->height = job->pitch = 0;
+	job->state = kJobQueued;
+
+	bool installTimer;
+	for (;;) {
+		{
+			Common::StackLock lock(_mutex);
+
+			// Drop the oldest images if they were not used, to make room.
+			// Images being decoded can not be dropped yet.
+			if (!isDecoding()) {
+				while (!_jobs.empty() && _decodedSize + job->decodedSize > kMaxDecodedSize) {
+					Job *oldest = _jobs.front();
+					_decodedSize -= oldest->decodedSize;
+					_jobs.pop_front();
+					deleteJob(oldest);
+				}
+
+				_jobs.push_back(job);
+				_decodedSize += job->decodedSize;
+				installTimer = !_timerInstalled;
+				_timerInstalled = true;
+				break;
+			}
+		}
+
+		waitForTimerProc();
+	}
+
+	// Install the timer without holding our lock, since the timer manager
+	// holds its own lock while calling timerProc, which takes ours. If
+	// timerProc is just removing itself, installing waits for that. Without
+	// the timer, take() decodes the images.
+	if (installTimer && !g_system->getTimerManager()->installTimerProc(&timerProc, kDecodeInterval, this, "Sword25ImagePrefetcher")) {
+		Common::StackLock lock(_mutex);
+		_timerInstalled = false;
+	}
+
+	return true;
+}
+
+bool ImagePrefetcher::take(const Common::String &fileName, byte *&pUncompressedData, int &width, int &height, int &pitch) {
+	Job *job;
+	for (;;) {
+		{
+			Common::StackLock lock(_mutex);
+			JobList::iterator i = findJob(fileName);
+			if (i == _jobs.end())
+				return false;
+
+			if ((*i)->state != kJobDecoding) {
+				job = *i;
+				_decodedSize -= job->decodedSize;
+				_jobs.erase(i);
+				break;
+			}
+		}
+
+		waitForTimerProc();
+	}
+
+	if (job->state == kJobQueued)
+		decode(job);
+
+	pUncompressedData = job->data;
+	width = job->width;
+	height = job->height;
+	pitch = job->pitch;
+
+	job->data = 0;
+	deleteJob(job);
+	return pUncompressedData != 0;
+}
+
+void ImagePrefetcher::clear() {
+	for (;;) {
+		{
+			Common::StackLock lock(_mutex);
+			if (!isDecoding()) {
+				for (JobList::iterator i = _jobs.begin(); i != _jobs.end(); ++i)
+					deleteJob(*i);
+				_jobs.clear();
+				_decodedSize = 0;
+				return;
+			}
+		}
+
+		waitForTimerProc();
+	}
+}
+
+void ImagePrefetcher::timerProc(void *refCon) {
+	ImagePrefetcher *prefetcher = (ImagePrefetcher *)refCon;
+
+	// Decode a single image per call without holding the lock, so that
+	// the engine can queue and take other images meanwhile.
+	Job *job = 0;
+	{
+		Common::StackLock lock(prefetcher->_mutex);
+		for (JobList::iterator i = prefetcher->_jobs.begin(); i != prefetcher->_jobs.end(); ++i) {
+			if ((*i)->state == kJobQueued) {
+				job = *i;
+				job->state = kJobDecoding;
+				break;
+			}
+		}
+
+		if (!job)
+			prefetcher->_timerInstalled = false;
+	}
+
+	if (!job) {
+		// Nothing left to decode, so stop calling us until the next prefetch()
+		g_system->getTimerManager()->removeTimerProc(&timerProc);
+		return;
+	}
+
+	decode(job);
+
+	Common::StackLock lock(prefetcher->_mutex);
+	job->state = kJobDecoded;
+}
+
+void ImagePrefetcher::decode(Job *job) {
+	// decodePNGImage does not call error(), so this is safe in the timer
+	// proc. A failed image is loaded again by the caller of take().
+	if (!ImgLoader::decodePNGImage(job->fileData, job->fileSize, job->data, job->width, job->height, job->pitch))
+		job->data = 0;
+
+	delete[] job->fileData;
+	job->fileData = 0;
+}
+
+void ImagePrefetcher::deleteJob(Job *job) {
+	delete[] job->fileData;
+	delete[] job->data;
+	delete job;
+}
+
+ImagePrefetcher::JobList::iterator ImagePrefetcher::findJob(const Common::String &fileName) {
+	JobList::iterator i = _jobs.begin();
+	while (i != _jobs.end() && (*i)->fileName != fileName)
+		++i;
+	return i;
+}
+
+bool ImagePrefetcher::isDecoding() const {
+	for (JobList::const_iterator i = _jobs.begin(); i != _jobs.end(); ++i) {
+		if ((*i)->state == kJobDecoding)
+			return true;
+	}
+	return false;
+}
+
+void ImagePrefetcher::waitForTimerProc() {
+	g_system->delayMillis(1);
+}
+
+} // End of namespace Sword25
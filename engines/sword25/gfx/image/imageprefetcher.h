@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SWORD25_IMAGEPREFETCHER_H
+#define SWORD25_IMAGEPREFETCHER_H
+
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/str.h"
+#include "sword25/kernel/common.h"
+
+namespace Sword25 {
+
+/**
+ * Decodes PNG images in the background, so that they are ready by the time
+ * the resource manager loads them.
+ *
+ * The file data is read when an image is queued, since the package manager
+ * must only be used from the engine thread. Only the decoding through
+ * ImgLoader::decodePNGImage runs in a timer proc, which is only installed
+ * while there are images to decode. Decoding errors are not reported there;
+ * take() fails for such images instead, so that the caller loads them again
+ * on the engine thread and reports the error.
+ */
+class ImagePrefetcher {
+public:
+	ImagePrefetcher();
+	~ImagePrefetcher();
+
+	/**
+	 * Queue an image for decoding.
+	 * @param fileName	the absolute filename of the image
+	 * @return false if the image is already queued or could not be read
+	 */
+	bool prefetch(const Common::String &fileName);
+
+	/**
+	 * Return the decoded data of a queued image and remove it from the
+	 * queue. If the image was not decoded yet, it is decoded right away.
+	 * The parameters are the same as those of ImgLoader::decodePNGImage.
+	 * @return false if the image was not queued or could not be decoded
+	 */
+	bool take(const Common::String &fileName, byte *&pUncompressedData, int &width, int &height, int &pitch);
+
+	/** Discard all queued images. */
+	void clear();
+
+private:
+	enum {
+		/** Maximum number of bytes held by decoded images not taken yet */
+		kMaxDecodedSize = 32 * 1024 * 1024,
+		/** Interval between timer calls in microseconds */
+		kDecodeInterval = 10 * 1000
+	};
+
+	enum JobState {
+		kJobQueued,
+		kJobDecoding,
+		kJobDecoded
+	};
+
+	struct Job {
+		Common::String fileName;
+		byte *fileData;
+		uint fileSize;
+		/** Size of the decoded image, as given in the PNG header */
+		uint decodedSize;
+		byte *data;
+		int width;
+		int height;
+		int pitch;
+		JobState state;
+	};
+
+	typedef Common::List<Job *> JobList;
+
+	static void timerProc(void *refCon);
+
+	static void decode(Job *job);
+	static void deleteJob(Job *job);
+
+	/** Return the job for an image. Must be called with the mutex held. */
+	JobList::iterator findJob(const Common::String &fileName);
+
+	/** Return whether a job is being decoded. Must be called with the mutex held. */
+	bool isDecoding() const;
+
+	/**
+	 * Give the timer proc time to finish decoding an image. Must be called
+	 * without holding the mutex.
+	 */
+	static void waitForTimerProc();
+
+	Common::Mutex _mutex;
+	JobList _jobs;
+	uint _decodedSize;
+	bool _timerInstalled;	///< Protected by _mutex
+};
+
+} // End of namespace Sword25
+
+#endif
@@ -40,9 +40,14 @@ namespace Sword25 {
 bool ImgLoader::decodePNGImage(const byte *fileDataPtr, uint fileSize, byte *&uncompressedDataPtr, int &width, int &height, int &pitch) {
 	Common::MemoryReadStream *fileStr = new Common::MemoryReadStream(fileDataPtr, fileSize, DisposeAfterUse::NO);
 
+	// This is also called by the ImagePrefetcher from a timer proc, so
+	// errors are left to the caller.
 	Graphics::PNGDecoder png;
-	if (!png.loadStream(*fileStr)) // the fileStr pointer, and thus pFileData will be deleted after this is done
-		error("Error while reading PNG image");
+	if (!png.loadStream(*fileStr)) {
+		warning("Error while reading PNG image");
+		delete fileStr;
+		return false;
+	}
 
 	const Graphics::Surface *sourceSurface = png.getSurface();
 	Graphics::Surface *pngSurface = sourceSurface->convertTo(Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24), png.getPalette());
@@ -110,38 +110,43 @@ RenderedImage::RenderedImage(const Common::String &filename, bool &result) :
 
 	_backSurface = Kernel::getInstance()->getGfx()->getSurface();
 
-	// Load file
-	byte *pFileData;
-	uint fileSize;
+	// Use the image if it has already been decoded in the background
+	int pitch;
+	if (!Kernel::getInstance()->getGfx()->takePrefetchedImage(filename, _data, _width, _height, pitch)) {
+		// Load file
+		byte *pFileData;
+		uint fileSize;
 
-	bool isPNG = true;
+		bool isPNG = true;
 
-	if (filename.hasPrefix("/saves")) {
-		pFileData = readSavegameThumbnail(filename, fileSize, isPNG);
-	} else {
-		pFileData = pPackage->getFile(filename, &fileSize);
-	}
+		if (filename.hasPrefix("/saves")) {
+			pFileData = readSavegameThumbnail(filename, fileSize, isPNG);
+		} else {
+			pFileData = pPackage->getFile(filename, &fileSize);
+		}
 
-	if (!pFileData) {
-		error("File \"%s\" could not be loaded.", filename.c_str());
-		return;
-	}
+		if (!pFileData) {
+			error("File \"%s\" could not be loaded.", filename.c_str());
+			return;
+		}
 
-	// Uncompress the image
-	int pitch;
-	if (isPNG)
-		result = ImgLoader::decodePNGImage(pFileData, fileSize, _data, _width, _height, pitch);
-	else
-		result = ImgLoader::decodeThumbnailImage(pFileData, fileSize, _data, _width, _height, pitch);
+		// Uncompress the image
+		if (isPNG)
+			result = ImgLoader::decodePNGImage(pFileData, fileSize, _data, _width, _height, pitch);
+		else
+			result = ImgLoader::decodeThumbnailImage(pFileData, fileSize, _data, _width, _height, pitch);
 
-	if (!result) {
-		error("Could not decode image.");
+		if (!result) {
+			error("Could not decode image.");
+			delete[] pFileData;
+			return;
+		}
+
+		// Cleanup FileData
 		delete[] pFileData;
-		return;
 	}
 
-	// Cleanup FileData
-	delete[] pFileData;
+	result = true;
 
 	_doCleanup = true;
 
@@ -215,7 +215,7 @@ Common::Rect CalculateBoundingBox(const VectorImageElement &vectorImageElement)
 // Construction
 // -----------------------------------------------------------------------------
 
-VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelData(0), _fname(fname) {
+VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _renderingCount(0), _fname(fname) {
 	success = false;
 
 	// Create bitstream object
@@ -300,8 +300,8 @@ VectorImage::~VectorImage() {
 			if (_elements[j].getPathInfo(i).getVec())
 				free(_elements[j].getPathInfo(i).getVec());
 
-	if (_pixelData)
-		free(_pixelData);
+	for (uint i = 0; i < _renderingCount; i++)
+		free(_renderings[i].pixelData);
 }
 
 
@@ -605,26 +605,42 @@ bool VectorImage::blit(int posX, int posY,
                        uint color,
                        int width, int height,
 					   RectangleList *updateRects) {
-	static VectorImage *oldThis = 0;
-	static int              oldWidth = -2;
-	static int              oldHeight = -2;
-
 	// If width or height to 0, nothing needs to be shown.
 	if (width == 0 || height == 0)
 		return true;
 
-	// Determine if the old image in the cache can not be reused and must be recalculated
-	if (!(oldThis == this && oldWidth == width && oldHeight == height)) {
-		render(width, height);
-
-		oldThis = this;
-		oldHeight = height;
-		oldWidth = width;
+	if (width == -1)
+		width = getWidth();
+	if (height == -1)
+		height = getHeight();
+
+	// Look for a rendering of the requested size. Each image keeps its own
+	// renderings, so that drawing several vector images per frame does not
+	// render them again and again.
+	uint i = 0;
+	while (i < _renderingCount && (_renderings[i].width != width || _renderings[i].height != height))
+		i++;
+
+	Rendering rendering;
+	if (i < _renderingCount) {
+		rendering = _renderings[i];
+	} else {
+		if (_renderingCount == kMaxRenderings)
+			free(_renderings[--_renderingCount].pixelData);
+
+		rendering.width = width;
+		rendering.height = height;
+		rendering.pixelData = render(width, height);
+		i = _renderingCount++;
 	}
 
+	for (; i > 0; i--)
+		_renderings[i] = _renderings[i - 1];
+	_renderings[0] = rendering;
+
 	RenderedImage *rend = new RenderedImage();
 
-	rend->replaceContent(_pixelData, width, height);
+	rend->replaceContent(rendering.pixelData, width, height);
 	rend->blit(posX, posY, flipping, pPartRect, color, width, height, updateRects);
 
 	delete rend;
@@ -183,7 +183,11 @@ public:
 	}
 	virtual bool fill(const Common::Rect *pFillRect = 0, uint color = BS_RGB(0, 0, 0));
 
-	void render(int width, int height);
+	/**
+	 * Renders the image at the given size.
+	 * @return the rendered 32 bit pixel data, which must be freed by the caller
+	 */
+	byte *render(int width, int height);
 
 	virtual uint getPixel(int x, int y);
 	virtual bool isBlitSource() const {
@@ -225,7 +229,20 @@ private:
 	Common::Array<VectorImageElement>    _elements;
 	Common::Rect                         _boundingBox;
 
-	byte *_pixelData;
+	enum {
+		/** Number of renderings at different sizes kept for blitting */
+		kMaxRenderings = 2
+	};
+
+	struct Rendering {
+		int width;
+		int height;
+		byte *pixelData;
+	};
+
+	/** Renderings of the image, the most recently used one first */
+	Rendering _renderings[kMaxRenderings];
+	uint _renderingCount;
 
 	Common::String _fname;
 };
@@ -255,6 +255,194 @@ void art_rgb_svp_alpha1(const ArtSVP *svp,
 		art_svp_render_aa(svp, x0, y0, x1, y1, art_rgb_svp_alpha_callback1, &data);
 }
 
+/**
+ * Coverage accumulation buffer used by fillVpath. Each line of a filled path
+ * adds the signed area it covers to the cells it crosses, and summing up a
+ * row from the left then yields the coverage of each pixel. fillVpath clears
+ * the cells it used again, so that one buffer can be used for all fills of
+ * an image.
+ */
+struct CoverageBuffer {
+	CoverageBuffer(int w, int h) : width(w), height(h) {
+		cells = (float *)calloc((width + 2) * height, sizeof(float));
+		rowLeft = (int *)malloc(height * sizeof(int));
+		rowRight = (int *)malloc(height * sizeof(int));
+		if (!cells || !rowLeft || !rowRight)
+			error("[CoverageBuffer] Cannot allocate memory");
+
+		for (int y = 0; y < height; y++) {
+			rowLeft[y] = width + 1;
+			rowRight[y] = -1;
+		}
+	}
+
+	~CoverageBuffer() {
+		free(cells);
+		free(rowLeft);
+		free(rowRight);
+	}
+
+	int width;
+	int height;
+	/** The accumulated coverage, width + 2 cells for each row */
+	float *cells;
+	/** The range of cells touched in each row */
+	int *rowLeft, *rowRight;
+};
+
+static void accumulateLine(CoverageBuffer &buffer, double x0, double y0, double x1, double y1) {
+	if (y0 == y1)
+		return;
+
+	float dir = 1.0f;
+	if (y0 > y1) {
+		SWAP(x0, x1);
+		SWAP(y0, y1);
+		dir = -1.0f;
+	}
+
+	const int width = buffer.width;
+	const int height = buffer.height;
+	if (width <= 0 || y1 <= 0 || y0 >= height)
+		return;
+
+	// Lines crossing the left or right border are split there, so that the
+	// part outside the image can be treated as a vertical line on the border.
+	for (int border = 0; border <= width; border += width) {
+		if ((x0 < border && x1 > border) || (x0 > border && x1 < border)) {
+			const double yBorder = y0 + (border - x0) * (y1 - y0) / (x1 - x0);
+			if (dir > 0) {
+				accumulateLine(buffer, x0, y0, border, yBorder);
+				accumulateLine(buffer, border, yBorder, x1, y1);
+			} else {
+				accumulateLine(buffer, x1, y1, border, yBorder);
+				accumulateLine(buffer, border, yBorder, x0, y0);
+			}
+			return;
+		}
+	}
+
+	const double dxdy = (x1 - x0) / (y1 - y0);
+	double x = x0;
+	if (y0 < 0) {
+		x -= y0 * dxdy;
+		y0 = 0;
+	}
+	if (y1 > height)
+		y1 = height;
+
+	const int yEnd = (int)ceil(y1);
+	for (int y = (int)y0; y < yEnd; y++) {
+		float *line = buffer.cells + y * (width + 2);
+		const double dy = MIN<double>(y + 1, y1) - MAX<double>(y, y0);
+		const double xNext = x + dxdy * dy;
+		const float d = (float)dy * dir;
+
+		// Coverage left of the image belongs to its first column, coverage
+		// right of it is not needed.
+		const double xLeft = CLIP<double>(MIN(x, xNext), 0, width);
+		const double xRight = CLIP<double>(MAX(x, xNext), 0, width);
+
+		const double xLeftFloor = floor(xLeft);
+		const int xLeftInt = (int)xLeftFloor;
+		const int xRightInt = (int)ceil(xRight);
+
+		if (xRightInt <= xLeftInt + 1) {
+			// The line stays within a single pixel of this row
+			const float xMid = (float)(0.5 * (xLeft + xRight) - xLeftFloor);
+			line[xLeftInt] += d - d * xMid;
+			line[xLeftInt + 1] += d * xMid;
+		} else {
+			const float s = (float)(1.0 / (xRight - xLeft));
+			const float xLeftFrac = (float)(xLeft - xLeftFloor);
+			const float a0 = 0.5f * s * (1.0f - xLeftFrac) * (1.0f - xLeftFrac);
+			const float xRightFrac = (float)(xRight - xRightInt + 1);
+			const float am = 0.5f * s * xRightFrac * xRightFrac;
+
+			line[xLeftInt] += d * a0;
+			if (xRightInt == xLeftInt + 2) {
+				line[xLeftInt + 1] += d * (1.0f - a0 - am);
+			} else {
+				const float a1 = s * (1.5f - xLeftFrac);
+				line[xLeftInt + 1] += d * (a1 - a0);
+				for (int xi = xLeftInt + 2; xi < xRightInt - 1; xi++)
+					line[xi] += d * s;
+				const float a2 = a1 + (xRightInt - xLeftInt - 3) * s;
+				line[xRightInt - 1] += d * (1.0f - a2 - am);
+			}
+			line[xRightInt] += d * am;
+		}
+
+		buffer.rowLeft[y] = MIN(buffer.rowLeft[y], xLeftInt);
+		buffer.rowRight[y] = MAX(buffer.rowRight[y], MAX(xRightInt, xLeftInt + 1));
+
+		x = xNext;
+	}
+}
+
+/**
+ * Fills the area enclosed by a vector path with anti-aliasing.
+ *
+ * Instead of building a sorted vector path for art_svp_render_aa, the lines
+ * are accumulated into a coverage buffer, which is then blended into the
+ * image row by row. Apart from rounding at the edges, the result matches
+ * art_rgb_svp_alpha1, which is still used for strokes.
+ */
+static void fillVpath(const ArtVpath *vect, CoverageBuffer &coverageBuffer, byte *buffer, uint32 color) {
+	int top = coverageBuffer.height;
+	int bottom = 0;
+
+	for (int i = 1; vect[i].code != ART_END; i++) {
+		if (vect[i].code != ART_LINETO)
+			continue;
+
+		accumulateLine(coverageBuffer, vect[i - 1].x, vect[i - 1].y, vect[i].x, vect[i].y);
+		top = MIN(top, (int)MIN(vect[i - 1].y, vect[i].y));
+		bottom = MAX(bottom, (int)ceil(MAX(vect[i - 1].y, vect[i].y)));
+	}
+
+	top = MAX(top, 0);
+	bottom = MIN(bottom, coverageBuffer.height);
+
+	byte r, g, b, alpha;
+	Graphics::colorToARGB<Graphics::ColorMasks<8888> >(color, alpha, r, g, b);
+
+	const int width = coverageBuffer.width;
+	for (int y = top; y < bottom; y++) {
+		const int left = coverageBuffer.rowLeft[y];
+		const int right = MIN(coverageBuffer.rowRight[y], width);
+		if (left > right)
+			continue;
+
+		float *line = coverageBuffer.cells + y * (width + 2);
+		byte *dst = buffer + (y * width) * 4;
+		float coverage = 0.0f;
+
+		int x = left;
+		while (x < right) {
+			coverage += line[x];
+
+			// The coverage only changes at cells touched by a line, so
+			// the pixels up to the next such cell are drawn as one run.
+			int runEnd = x + 1;
+			while (runEnd < right && line[runEnd] == 0.0f)
+				runEnd++;
+
+			const int pixelAlpha = (int)(MIN<float>(fabs(coverage), 1.0f) * alpha + 0.5f);
+			if (pixelAlpha >= 255)
+				art_rgb_fill_run1(dst + x * 4, r, g, b, runEnd - x);
+			else if (pixelAlpha > 0)
+				art_rgb_run_alpha1(dst + x * 4, r, g, b, pixelAlpha, runEnd - x);
+
+			x = runEnd;
+		}
+
+		memset(line + left, 0, (coverageBuffer.rowRight[y] - left + 1) * sizeof(float));
+		coverageBuffer.rowLeft[y] = width + 1;
+		coverageBuffer.rowRight[y] = -1;
+	}
+}
+
 static int art_vpath_len(ArtVpath *a) {
 	int i = 0;
 	while (a[i].code != ART_END)
@@ -283,16 +471,6 @@ ArtVpath *art_vpath_cat(ArtVpath *a, ArtVpath *b) {
 	return dest;
 }
 
-void art_svp_make_convex(ArtSVP *svp) {
-	int i;
-
-	if (svp->n_segs > 0 && svp->segs[0].dir == 0) {
-		for (i = 0; i < svp->n_segs; i++) {
-			svp->segs[i].dir = !svp->segs[i].dir;
-		}
-	}
-}
-
 ArtVpath *art_vpath_reverse(ArtVpath *a) {
 	ArtVpath *dest;
 	ArtVpath it;
@@ -333,7 +511,7 @@ ArtVpath *art_vpath_reverse_free(ArtVpath *a) {
 	return dest;
 }
 
-void drawBez(ArtBpath *bez1, ArtBpath *bez2, byte *buffer, int width, int height, int deltaX, int deltaY, double scaleX, double scaleY, double penWidth, unsigned int color) {
+void drawBez(ArtBpath *bez1, ArtBpath *bez2, byte *buffer, CoverageBuffer &coverageBuffer, int width, int height, int deltaX, int deltaY, double scaleX, double scaleY, double penWidth, unsigned int color) {
 	ArtVpath *vec = NULL;
 	ArtVpath *vec1 = NULL;
 	ArtVpath *vec2 = NULL;
@@ -389,29 +567,26 @@ void drawBez(ArtBpath *bez1, ArtBpath *bez2, byte *buffer, int width, int height
 
 	if (bez2 == 0) { // Line drawing
 		svp = art_svp_vpath_stroke(vect, ART_PATH_STROKE_JOIN_ROUND, ART_PATH_STROKE_CAP_ROUND, penWidth, 1.0, 0.5);
+		art_rgb_svp_alpha1(svp, 0, 0, width, height, color, buffer, width * 4);
+		art_svp_free(svp);
 	} else {
-		svp = art_svp_from_vpath(vect);
-		art_svp_make_convex(svp);
+		fillVpath(vect, coverageBuffer, buffer, color);
 	}
 
-	art_rgb_svp_alpha1(svp, 0, 0, width, height, color, buffer, width * 4);
-
 	free(vect);
-	art_svp_free(svp);
 	free(vec);
 }
 
-void VectorImage::render(int width, int height) {
+byte *VectorImage::render(int width, int height) {
 	double scaleX = (width == - 1) ? 1 : static_cast<double>(width) / static_cast<double>(getWidth());
 	double scaleY = (height == - 1) ? 1 : static_cast<double>(height) / static_cast<double>(getHeight());
 
 	debug(3, "VectorImage::render(%d, %d) %s", width, height, _fname.c_str());
 
-	if (_pixelData)
-		free(_pixelData);
+	byte *pixelData = (byte *)malloc(width * height * 4);
+	memset(pixelData, 0, width * height * 4);
 
-	_pixelData = (byte *)malloc(width * height * 4);
-	memset(_pixelData, 0, width * height * 4);
+	CoverageBuffer coverageBuffer(width, height);
 
 	for (uint e = 0; e < _elements.size(); e++) {
 
@@ -452,7 +627,7 @@ void VectorImage::render(int width, int height) {
 			(*fill0pos).code = ART_END;
 			(*fill1pos).code = ART_END;
 
-			drawBez(fill1, fill0, _pixelData, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, -1, _elements[e].getFillStyleColor(s));
+			drawBez(fill1, fill0, pixelData, coverageBuffer, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, -1, _elements[e].getFillStyleColor(s));
 
 			free(fill0);
 			free(fill1);
@@ -465,11 +640,13 @@ void VectorImage::render(int width, int height) {
 
 			for (uint p = 0; p < _elements[e].getPathCount(); p++) {
 				if (_elements[e].getPathInfo(p).getLineStyle() == s + 1) {
-					drawBez(_elements[e].getPathInfo(p).getVec(), 0, _pixelData, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, penWidth, _elements[e].getLineStyleColor(s));
+					drawBez(_elements[e].getPathInfo(p).getVec(), 0, pixelData, coverageBuffer, width, height, _boundingBox.left, _boundingBox.top, scaleX, scaleY, penWidth, _elements[e].getLineStyleColor(s));
 				}
 			}
 		}
 	}
+
+	return pixelData;
 }
 
 
@@ -46,6 +46,10 @@
 #include "sword25/gfx/text.h"
 #include "sword25/gfx/animationtemplate.h"
 
+namespace Common {
+DECLARE_SINGLETON(Sword25::RenderObjectRegistry);
+}
+
 namespace Sword25 {
 
 int RenderObject::_nextGlobalVersion = 0;
@@ -100,6 +104,10 @@ RenderObject::RenderObject(RenderObjectPtr<RenderObject> parentPtr, TYPES type,
 }
 
 RenderObject::~RenderObject() {
+	// The area covered by the object has to be redrawn without it.
+	if (_managerPtr && _oldVisible)
+		_managerPtr->addDirtyRect(_bbox);
+
 	// Objekt aus dem Elternobjekt entfernen.
 	if (_parentPtr.isValid())
 		_parentPtr->detatchChildren(this->getHandle());
@@ -131,28 +139,49 @@ void RenderObject::preRender(RenderObjectQueue *renderQueue) {
 
 }
 
-bool RenderObject::render(RectangleList *updateRects, const Common::Array<int> &updateRectsMinZ) {
+bool RenderObject::render(RectangleList *updateRects, const Common::Array<int> &updateRectsMinZ, RenderStats &stats) {
 
 	// Falls das Objekt nicht sichtbar ist, muss gar nichts gezeichnet werden
 	if (!_visible)
 		return true;
 
+	++stats.objectsVisited;
+
 	// Objekt zeichnen.
+	bool intersects = false;
 	bool needRender = false;
+	uint32 pixels = 0;
 	int index = 0;
 
 	// Only draw if the bounding box intersects any update rectangle and
 	// the object is in front of the minimum Z value.
-	for (RectangleList::iterator rectIt = updateRects->begin(); !needRender && rectIt != updateRects->end(); ++rectIt, ++index)
-		needRender = (_bbox.contains(*rectIt) || _bbox.intersects(*rectIt)) && getAbsoluteZ() >= updateRectsMinZ[index];
+	for (RectangleList::iterator rectIt = updateRects->begin(); rectIt != updateRects->end(); ++rectIt, ++index) {
+		if (!_bbox.intersects(*rectIt))
+			continue;
+
+		intersects = true;
+		needRender |= getAbsoluteZ() >= updateRectsMinZ[index];
 
-	if (needRender)
+		Common::Rect area(*rectIt);
+		area.clip(_bbox);
+		pixels += area.width() * area.height();
+	}
+
+	// The bounding boxes of the children are clipped to this one, so they
+	// don't need to be visited either.
+	if (!intersects)
+		return true;
+
+	if (needRender) {
+		++stats.objectsRendered;
+		stats.pixelsBlitted += pixels;
 		doRender(updateRects);
+	}
 
 	// Dann mssen die Kinder gezeichnet werden
 	RENDEROBJECT_ITER it = _children.begin();
 	for (; it != _children.end(); ++it)
-		if (!(*it)->render(updateRects, updateRectsMinZ))
+		if (!(*it)->render(updateRects, updateRectsMinZ, stats))
 			return false;
 
 	return true;
@@ -182,7 +211,11 @@ bool RenderObject::updateObjectState() {
 			_parentPtr->signalChildChange();
 
 		// Die Bounding-Box neu berechnen und Update-Regions registrieren.
+		if (_managerPtr && _oldVisible)
+			_managerPtr->addDirtyRect(_oldBbox);
 		updateBoxes();
+		if (_managerPtr && _visible)
+			_managerPtr->addDirtyRect(_bbox);
 		
 		++_version;
 
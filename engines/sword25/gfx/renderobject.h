@@ -55,6 +55,7 @@ class Kernel;
 class RenderObjectManager;
 class RenderObjectQueue;
 class RectangleList;
+struct RenderStats;
 class Bitmap;
 class Animation;
 class AnimationTemplate;
@@ -223,7 +224,7 @@ public:
 	            Dieses kann entweder direkt geschehen oder durch den Aufruf von UpdateObjectState() an einem Vorfahren-Objekt.<br>
 	            Diese Methode darf nur von BS_RenderObjectManager aufgerufen werden.
 	*/
-	bool render(RectangleList *updateRects, const Common::Array<int> &updateRectsMinZ);
+	bool render(RectangleList *updateRects, const Common::Array<int> &updateRectsMinZ, RenderStats &stats);
 
 	/**
 	    @brief Bereitet das Objekt und alle seine Unterobjekte auf einen Rendervorgang vor.
@@ -49,21 +49,14 @@ void RenderObjectQueue::add(RenderObject *renderObject) {
 	push_back(RenderObjectQueueItem(renderObject, renderObject->getBbox(), renderObject->getVersion()));
 }
 
-bool RenderObjectQueue::exists(const RenderObjectQueueItem &renderObjectQueueItem) {
-	for (RenderObjectQueue::iterator it = begin(); it != end(); ++it)
-		if ((*it)._renderObject == renderObjectQueueItem._renderObject &&
-			(*it)._version == renderObjectQueueItem._version)
-			return true;
-	return false;
-}
-
 RenderObjectManager::RenderObjectManager(int width, int height, int framebufferCount) :
 	_frameStarted(false) {
-	// Wurzel des BS_RenderObject-Baumes erzeugen.
-	_rootPtr = (new RootRenderObject(this, width, height))->getHandle();
+	memset(&_renderStats, 0, sizeof(_renderStats));
 	_uta = new MicroTileArray(width, height);
 	_currQueue = new RenderObjectQueue();
-	_prevQueue = new RenderObjectQueue();
+
+	// Wurzel des BS_RenderObject-Baumes erzeugen.
+	_rootPtr = (new RootRenderObject(this, width, height))->getHandle();
 }
 
 RenderObjectManager::~RenderObjectManager() {
@@ -71,7 +64,6 @@ RenderObjectManager::~RenderObjectManager() {
 	_rootPtr.erase();
 	delete _uta;
 	delete _currQueue;
-	delete _prevQueue;
 }
 
 void RenderObjectManager::startFrame() {
@@ -95,23 +87,21 @@ bool RenderObjectManager::render() {
 
 	_frameStarted = false;
 
-	// Die Render-Methode der Wurzel aufrufen. Dadurch wird das rekursive Rendern der Baumelemente angestoen.
-
-	_currQueue->clear();
-	_rootPtr->preRender(_currQueue);
+	memset(&_renderStats, 0, sizeof(_renderStats));
 
+	// The objects which changed, appeared or disappeared since the last frame
+	// have reported their areas, so only these need to be redrawn.
+	RectangleList *updateRects = _uta->getRectangles();
 	_uta->clear();
 
-	// Add rectangles of objects which don't exist in this frame any more
-    for (RenderObjectQueue::iterator it = _prevQueue->begin(); it != _prevQueue->end(); ++it)
-    	if (!_currQueue->exists(*it))
-    		_uta->addRect((*it)._bbox);
-    // Add rectangles of objects which are different from the previous frame
-    for (RenderObjectQueue::iterator it = _currQueue->begin(); it != _currQueue->end(); ++it)
-    	if (!_prevQueue->exists(*it))
-    		_uta->addRect((*it)._bbox);
+	if (updateRects->empty()) {
+		delete updateRects;
+		return true;
+	}
+
+	_currQueue->clear();
+	_rootPtr->preRender(_currQueue);
 
-	RectangleList *updateRects = _uta->getRectangles();
 	Common::Array<int> updateRectsMinZ;
 	
 	updateRectsMinZ.reserve(updateRects->size());
@@ -131,7 +121,8 @@ bool RenderObjectManager::render() {
 		updateRectsMinZ.push_back(minZ);
 	}
 
-	if (_rootPtr->render(updateRects, updateRectsMinZ)) {
+	// Die Render-Methode der Wurzel aufrufen. Dadurch wird das rekursive Rendern der Baumelemente angestoen.
+	if (_rootPtr->render(updateRects, updateRectsMinZ, _renderStats)) {
 		// Copy updated rectangles to the video screen
 		Graphics::Surface *backSurface = Kernel::getInstance()->getGfx()->getSurface();
 		for (RectangleList::iterator rectIt = updateRects->begin(); rectIt != updateRects->end(); ++rectIt) {
@@ -140,16 +131,26 @@ bool RenderObjectManager::render() {
 			const int width = (*rectIt).width();
 			const int height = (*rectIt).height();
 			g_system->copyRectToScreen(backSurface->getBasePtr(x, y), backSurface->pitch, x, y, width, height);
+
+			++_renderStats.updateRects;
+			_renderStats.pixelsPresented += width * height;
 		}
 	}
 
 	delete updateRects;
-	
-	SWAP(_currQueue, _prevQueue);
-	
+
+	debug(5, "RenderObjectManager: %u of %u objects drawn, %u pixels blitted, %u rects with %u pixels presented",
+	      _renderStats.objectsRendered, _renderStats.objectsVisited, _renderStats.pixelsBlitted,
+	      _renderStats.updateRects, _renderStats.pixelsPresented);
+
 	return true;
 }
 
+void RenderObjectManager::addDirtyRect(const Common::Rect &rect) {
+	if (!rect.isEmpty())
+		_uta->addRect(rect);
+}
+
 void RenderObjectManager::attatchTimedRenderObject(RenderObjectPtr<TimedRenderObject> renderObjectPtr) {
 	_timedRenderObjects.push_back(renderObjectPtr);
 }
@@ -196,6 +197,9 @@ bool RenderObjectManager::unpersist(InputPersistenceBlock &reader) {
 
 	reader.read(_frameStarted);
 
+	// The whole screen has to be redrawn with the restored objects.
+	addDirtyRect(_rootPtr->getBbox());
+
 	// Momentan gespeicherte Referenzen auf TimedRenderObjects lschen.
 	_timedRenderObjects.resize(0);
 
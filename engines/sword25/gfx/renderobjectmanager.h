@@ -67,7 +67,22 @@ struct RenderObjectQueueItem {
 class RenderObjectQueue : public Common::List<RenderObjectQueueItem> {
 public:
 	void add(RenderObject *renderObject);
-	bool exists(const RenderObjectQueueItem &renderObjectQueueItem);
+};
+
+/**
+ * Statistics about the last frame drawn by RenderObjectManager::render().
+ */
+struct RenderStats {
+	/** Number of render objects visited while drawing */
+	uint32 objectsVisited;
+	/** Number of render objects which were drawn */
+	uint32 objectsRendered;
+	/** Number of pixels the drawn objects covered within the update rectangles */
+	uint32 pixelsBlitted;
+	/** Number of rectangles copied to the screen */
+	uint32 updateRects;
+	/** Number of pixels copied to the screen */
+	uint32 pixelsPresented;
 };
 
 /**
@@ -123,6 +138,20 @@ public:
 	*/
 	void detatchTimedRenderObject(RenderObjectPtr<TimedRenderObject> pRenderObject);
 
+	/**
+	 * Marks an area of the screen to be redrawn by the next call of render().
+	 * Render objects report their previous and current bounding boxes here
+	 * whenever they change, appear or disappear.
+	 */
+	void addDirtyRect(const Common::Rect &rect);
+
+	/**
+	 * Returns statistics about the last frame drawn by render().
+	 */
+	const RenderStats &getRenderStats() const {
+		return _renderStats;
+	}
+
 	virtual bool persist(OutputPersistenceBlock &writer);
 	virtual bool unpersist(InputPersistenceBlock &reader);
 
@@ -132,7 +161,8 @@ private:
 	RenderObjectList _timedRenderObjects;
 
 	MicroTileArray *_uta;
-	RenderObjectQueue *_currQueue, *_prevQueue;
+	RenderObjectQueue *_currQueue;
+	RenderStats _renderStats;
 
 	// RenderObject-Tree Variablen
 	// ---------------------------
@@ -312,6 +312,9 @@ static int precacheResource(lua_State *L) {
 #ifdef PRECACHE_RESOURCES
 	lua_pushbooleancpp(L, pResource->precacheResource(luaL_checkstring(L, 1)));
 #else
+	// Let the resource be decoded in the background if possible. The
+	// scripts do not expect precaching to fail.
+	pResource->prefetchResource(luaL_checkstring(L, 1));
 	lua_pushbooleancpp(L, true);
 #endif
 
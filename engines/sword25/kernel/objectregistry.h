@@ -33,7 +33,7 @@
 #define SWORD25_OBJECTREGISTRY_H
 
 #include "common/func.h"
-#include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "common/textconsole.h"
 #include "sword25/kernel/common.h"
 
@@ -139,8 +139,11 @@ protected:
 		}
 	};
 
-	typedef Common::HashMap<uint, T *>  HANDLE2PTR_MAP;
-	typedef Common::HashMap<T *, uint, ClassPointer_Hash, ClassPointer_EqualTo> PTR2HANDLE_MAP;
+	// Handles are resolved on every access through a RenderObjectPtr, so
+	// the maps use the faster FlatHashMap. Values are only ever copied out
+	// of them, so entries moving on insertion does no harm.
+	typedef Common::FlatHashMap<uint, T *>  HANDLE2PTR_MAP;
+	typedef Common::FlatHashMap<T *, uint, ClassPointer_Hash, ClassPointer_EqualTo> PTR2HANDLE_MAP;
 
 	HANDLE2PTR_MAP  _handle2PtrMap;
 	PTR2HANDLE_MAP  _ptr2HandleMap;
@@ -29,6 +29,8 @@
  *
  */
 
+#include "common/config-manager.h"
+
 #include "sword25/sword25.h"	// for kDebugResource
 #include "sword25/kernel/resmanager.h"
 #include "sword25/kernel/resource.h"
@@ -37,15 +39,22 @@
 
 namespace Sword25 {
 
-// Sets the amount of resources that are simultaneously loaded.
-// This needs to be a relatively high number, as all the animation
-// frames in each scene are loaded as separate resources.
-// Also, George's walk states are all loaded here (150 files)
-#define SWORD25_RESOURCECACHE_MIN 400
-// The maximum number of loaded resources. If more than these resources
-// are loaded, the resource manager will start purging resources till it
-// hits the minimum limit above
-#define SWORD25_RESOURCECACHE_MAX 500
+// The default size of the resource cache in megabytes, which can be changed
+// with the "resource_cache_size" setting. This needs to be relatively large,
+// as all the animation frames in each scene are loaded as separate
+// resources. Also, George's walk states are all loaded here (150 files).
+// If the loaded resources use more memory, the resource manager starts
+// purging resources which are not in use.
+#define SWORD25_RESOURCECACHE_SIZE 128
+
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_usedMemory(0) {
+	int cacheSize = SWORD25_RESOURCECACHE_SIZE;
+	if (ConfMan.hasKey("resource_cache_size"))
+		cacheSize = MAX(ConfMan.getInt("resource_cache_size"), 1);
+	_maxMemory = cacheSize * 1024 * 1024;
+}
 
 ResourceManager::~ResourceManager() {
 	// Clear all unlocked resources
@@ -87,7 +96,7 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  */
 void ResourceManager::deleteResourcesIfNecessary() {
 	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	if (_usedMemory <= _maxMemory || _resources.empty())
 		return;
 
 	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
@@ -100,14 +109,15 @@ void ResourceManager::deleteResourcesIfNecessary() {
 		// The resource may be released only if it isn't locked
 		if ((*iter)->getLockCount() == 0)
 			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	} while (iter != _resources.begin() && _usedMemory > _maxMemory);
 
-	// Are we still above the minimum? If yes, then start releasing locked resources
+	// Are the locked resources using far more memory than allowed? If yes, then
+	// start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	if (_usedMemory <= 2 * _maxMemory)
 		return;
 
 	iter = _resources.end();
@@ -126,7 +136,7 @@ void ResourceManager::deleteResourcesIfNecessary() {
 
 			iter = deleteResource(*iter);
 		}
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	} while (iter != _resources.begin() && _usedMemory > _maxMemory);
 }
 
 /**
@@ -183,6 +193,27 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	return NULL;
 }
 
+/**
+ * Starts loading a resource in the background
+ * @param FileName      The filename of the resource to be prefetched
+ */
+bool ResourceManager::prefetchResource(const Common::String &fileName) {
+	// Get the absolute path to the file
+	Common::String uniqueFileName = getUniqueFileName(fileName);
+	if (uniqueFileName.empty())
+		return false;
+
+	if (getResource(uniqueFileName))
+		return true;
+
+	for (uint i = 0; i < _resourceServices.size(); ++i) {
+		if (_resourceServices[i]->canLoadResource(uniqueFileName))
+			return _resourceServices[i]->prefetchResource(uniqueFileName);
+	}
+
+	return false;
+}
+
 #ifdef PRECACHE_RESOURCES
 
 /**
@@ -260,6 +291,8 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
+			_usedMemory += pResource->getMemorySize();
+
 			return pResource;
 		}
 	}
@@ -299,6 +332,8 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
+	_usedMemory -= pResource->getMemorySize();
+
 	// Delete the resource
 	delete pResource;
 
@@ -324,6 +359,8 @@ Resource *ResourceManager::getResource(const Common::String &uniquefileName) con
  * Writes the names of all currently locked resources to the log file
  */
 void ResourceManager::dumpLockedResources() {
+	debugC(kDebugResource, "%u resources using %u KB loaded", _resources.size(), _usedMemory / 1024);
+
 	for (Common::List<Resource *>::iterator iter = _resources.begin(); iter != _resources.end(); ++iter) {
 		if ((*iter)->getLockCount() > 0) {
 			debugC(kDebugResource, "%s", (*iter)->getFileName().c_str());
@@ -33,7 +33,7 @@
 #define SWORD25_RESOURCEMANAGER_H
 
 #include "common/list.h"
-#include "common/hashmap.h"
+#include "common/flathashmap.h"
 #include "common/hash-str.h"
 
 #include "sword25/kernel/common.h"
@@ -66,6 +66,15 @@ public:
 	bool precacheResource(const Common::String &fileName, bool forceReload = false);
 #endif
 
+	/**
+	 * Starts loading a resource in the background, if its resource service
+	 * supports this. Unlike precacheResource(), this does not block until
+	 * the resource is loaded.
+	 * @param FileName      The filename of the resource to be prefetched
+	 * @return              Returns true if the resource is loaded or being prefetched.
+	 */
+	bool prefetchResource(const Common::String &fileName);
+
 	/**
 	 * Registers a RegisterResourceService. This method is the constructor of
 	 * BS_ResourceService, and thus helps all resource services in the ResourceManager list
@@ -93,9 +102,7 @@ private:
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
 	/**
@@ -135,9 +142,14 @@ private:
 	void deleteResourcesIfNecessary();
 
 	Kernel *_kernelPtr;
+	uint _usedMemory;	///< Sum of the memory sizes of all loaded resources
+	uint _maxMemory;	///< Memory size above which unused resources are released
 	Common::Array<ResourceService *> _resourceServices;
 	Common::List<Resource *> _resources;
-	typedef Common::HashMap<Common::String, Resource *> ResMap;
+	// Animations request the resource of their current frame every time they
+	// are drawn, so the name lookup uses the faster FlatHashMap. Only the
+	// Resource pointers are handed out, never references into the map.
+	typedef Common::FlatHashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
 };
 
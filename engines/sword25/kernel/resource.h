@@ -92,6 +92,15 @@ public:
 		return _type;
 	}
 
+	/**
+	 * Returns the approximate number of bytes of memory used by the resource.
+	 * This is used by the resource manager to limit the size of its cache.
+	 */
+	virtual uint getMemorySize() const {
+		// Rough size of a resource without large data of its own
+		return 1024;
+	}
+
 protected:
 	virtual ~Resource() {}
 
@@ -63,6 +63,16 @@ public:
 	 */
 	virtual bool canLoadResource(const Common::String &fileName) = 0;
 
+	/**
+	 * Starts loading a resource in the background, so that loadResource()
+	 * is quicker later on.
+	 * @param FileName  The absolute filename of the resource
+	 * @return          Returns true if the resource is being prefetched.
+	 */
+	virtual bool prefetchResource(const Common::String &fileName) {
+		return false;
+	}
+
 };
 
 } // End of namespace Sword25
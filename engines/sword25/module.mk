@@ -25,6 +25,7 @@ MODULE_OBJS := \
 	gfx/text.o \
 	gfx/timedrenderobject.o \
 	gfx/image/art.o \
+	gfx/image/imageprefetcher.o \
 	gfx/image/imgloader.o \
 	gfx/image/renderedimage.o \
 	gfx/image/swimage.o \
@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/coroutines.h"
 #include "tinsel/tinsel.h"
 #include "tinsel/debugger.h"
 #include "tinsel/dialogs.h"
@@ -67,6 +68,7 @@ Console::Console() : GUI::Debugger() {
 	DCmd_Register("music",		WRAP_METHOD(Console, cmd_music));
 	DCmd_Register("sound",		WRAP_METHOD(Console, cmd_sound));
 	DCmd_Register("string",		WRAP_METHOD(Console, cmd_string));
+	DCmd_Register("processes",	WRAP_METHOD(Console, cmd_processes));
 }
 
 Console::~Console() {
@@ -161,4 +163,19 @@ bool Console::cmd_string(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmd_processes(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		CoroScheduler.resetProcessStats();
+		return true;
+	} else if (argc != 1) {
+		DebugPrintf("%s [reset]\n", argv[0]);
+		DebugPrintf("Lists the processes with their timing counters, or resets the counters\n");
+		DebugPrintf("Times are measured in whole milliseconds, so short runs count as 0 ms\n");
+		return true;
+	}
+
+	DebugPrintf("%s", CoroScheduler.getProcessStats().c_str());
+	return true;
+}
+
 } // End of namespace Tinsel
@@ -23,6 +23,7 @@
 #include "base/plugins.h"
 
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 #include "common/file.h"
 #include "common/md5.h"
 #include "common/savefile.h"
@@ -246,14 +247,9 @@ const ADGameDescription *TinselMetaEngine::fallbackDetect(const FileMap &allFile
 			Common::String fname(tempFilename);
 			if (allFiles.contains(fname) && !filesSizeMD5.contains(fname)) {
 				SizeMD5 tmp;
-				Common::File testFile;
 
-				if (testFile.open(allFiles[fname])) {
-					tmp.size = (int32)testFile.size();
-					tmp.md5 = computeStreamMD5AsString(testFile, _md5Bytes);
-				} else {
+				if (!DetectionCache::instance().getFileProperties(allFiles[fname], _md5Bytes, tmp.size, tmp.md5))
 					tmp.size = -1;
-				}
 
 				filesSizeMD5[fname] = tmp;
 			}
@@ -41,6 +41,8 @@ namespace Tinsel {
 struct MEM_NODE {
 	MEM_NODE *pNext;	// link to the next node in the list
 	MEM_NODE *pPrev;	// link to the previous node in the list
+	MEM_NODE *pLruNext;	// link to the next more recently used discardable node
+	MEM_NODE *pLruPrev;	// link to the next less recently used discardable node
 	uint8 *pBaseAddr;	// base address of the memory object
 	long size;		// size of the memory object
 	uint32 lruTime;		// time when memory object was last accessed
@@ -69,6 +71,9 @@ MEM_NODE g_s_fixedMnodesList[5];
 // the mnode heap sentinel
 static MEM_NODE g_heapSentinel;
 
+// the sentinel of the list of discardable mnodes, least recently used first
+static MEM_NODE g_lruSentinel;
+
 //
 static MEM_NODE *AllocMemNode();
 
@@ -78,6 +83,8 @@ static void MemoryStats() {
 	int allocedNodes = 0;
 	int lockedNodes = 0;
 	int lockedSize = 0;
+	int discardableNodes = 0;
+	int discardableSize = 0;
 	int totalSize = 0;
 
 	const MEM_NODE *pHeap = &g_heapSentinel;
@@ -94,11 +101,45 @@ static void MemoryStats() {
 		}
 	}
 
-	debug("%d nodes used, %d alloced, %d locked; %d bytes locked, %d used",
-			usedNodes, allocedNodes, lockedNodes, lockedSize, totalSize);
+	for (pCur = g_lruSentinel.pLruNext; pCur != &g_lruSentinel; pCur = pCur->pLruNext) {
+		discardableNodes++;
+		discardableSize += pCur->size;
+	}
+
+	debug("%d nodes used, %d alloced, %d locked, %d discardable; %d bytes locked, %d discardable, %d used, %d free",
+			usedNodes, allocedNodes, lockedNodes, discardableNodes, lockedSize, discardableSize, totalSize, (int)g_heapSentinel.size);
 }
 #endif
 
+/**
+ * Appends a memory object to the end of the LRU list, if it can be discarded.
+ * @param pMemNode			Node of the memory object
+ */
+static void LruAppend(MEM_NODE *pMemNode) {
+	// only unlocked, non-discarded heap blocks are discardable
+	if (pMemNode < g_mnodeList || pMemNode >= g_mnodeList + NUM_MNODES || pMemNode->flags != DWM_USED)
+		return;
+
+	pMemNode->pLruPrev = g_lruSentinel.pLruPrev;
+	pMemNode->pLruNext = &g_lruSentinel;
+	g_lruSentinel.pLruPrev->pLruNext = pMemNode;
+	g_lruSentinel.pLruPrev = pMemNode;
+}
+
+/**
+ * Removes a memory object from the LRU list, if it is in there.
+ * @param pMemNode			Node of the memory object
+ */
+static void LruRemove(MEM_NODE *pMemNode) {
+	if (!pMemNode->pLruNext)
+		return;
+
+	pMemNode->pLruPrev->pLruNext = pMemNode->pLruNext;
+	pMemNode->pLruNext->pLruPrev = pMemNode->pLruPrev;
+	pMemNode->pLruNext = NULL;
+	pMemNode->pLruPrev = NULL;
+}
+
 /**
  * Initializes the memory manager.
  */
@@ -125,6 +166,11 @@ void MemoryInit() {
 	// flag sentinel as locked
 	g_heapSentinel.flags = DWM_LOCKED | DWM_SENTINEL;
 
+	// the LRU list starts out empty
+	g_lruSentinel.pLruPrev = &g_lruSentinel;
+	g_lruSentinel.pLruNext = &g_lruSentinel;
+	g_lruSentinel.flags = DWM_LOCKED | DWM_SENTINEL;
+
 	// store the current heap size in the sentinel
 	uint32 size = MemoryPoolSize[0];
 	if (TinselVersion == TINSEL_V1) size = MemoryPoolSize[1];
@@ -194,28 +240,22 @@ void FreeMemNode(MEM_NODE *pMemNode) {
  * @return true if any blocks were discarded, false otherwise
  */
 static bool HeapCompact(long size) {
-	const MEM_NODE *pHeap = &g_heapSentinel;
-	MEM_NODE *pCur, *pOldest;
-	uint32 oldest;		// time of the oldest discardable block
+	const uint32 now = DwGetCurrentTime();
+	MEM_NODE *pCur;
 
 	while (g_heapSentinel.size < size) {
 
-		// find the oldest discardable block
-		oldest = DwGetCurrentTime();
-		pOldest = NULL;
-		for (pCur = pHeap->pNext; pCur != pHeap; pCur = pCur->pNext) {
-			if (pCur->flags == DWM_USED) {
-				// found a non-discarded discardable block
-				if (pCur->lruTime < oldest) {
-					oldest = pCur->lruTime;
-					pOldest = pCur;
-				}
-			}
+		// The LRU list holds the discardable blocks in the order they were
+		// used, so the oldest one is found near its start. Blocks used in
+		// the current tick are not discarded.
+		for (pCur = g_lruSentinel.pLruNext; pCur != &g_lruSentinel; pCur = pCur->pLruNext) {
+			if (pCur->lruTime < now)
+				break;
 		}
 
-		if (pOldest)
+		if (pCur != &g_lruSentinel)
 			// discard the oldest block
-			MemoryDiscard(pOldest);
+			MemoryDiscard(pCur);
 		else
 			// cannot discard any blocks
 			return false;
@@ -274,6 +314,9 @@ static MEM_NODE *MemoryAlloc(long size) {
 	pHeap->pPrev->pNext = pNode;
 	pHeap->pPrev = pNode;
 
+	// the new block is the most recently used one
+	LruAppend(pNode);
+
 	return pNode;
 }
 
@@ -349,6 +392,8 @@ void MemoryDiscard(MEM_NODE *pMemNode) {
 
 	// discard it if it isn't already
 	if ((pMemNode->flags & DWM_DISCARDED) == 0) {
+		LruRemove(pMemNode);
+
 		// free memory
 		free(pMemNode->pBaseAddr);
 		g_heapSentinel.size += pMemNode->size;
@@ -379,6 +424,7 @@ void *MemoryLock(MEM_NODE *pMemNode) {
 
 	// set the lock flag
 	pMemNode->flags |= DWM_LOCKED;
+	LruRemove(pMemNode);
 
 #ifdef DEBUG
 	MemoryStats();
@@ -405,6 +451,7 @@ void MemoryUnlock(MEM_NODE *pMemNode) {
 
 	// update the LRU time
 	pMemNode->lruTime = DwGetCurrentTime();
+	LruAppend(pMemNode);
 }
 
 /**
@@ -440,11 +487,13 @@ void MemoryReAlloc(MEM_NODE *pMemNode, long size) {
 		assert(pNew != NULL);
 
 		// copy the node to the current node
+		LruRemove(pNew);
 		memcpy(pMemNode, pNew, sizeof(MEM_NODE));
 
-		// relink the mnode into the list
+		// relink the mnode into the lists
 		pMemNode->pPrev->pNext = pMemNode;
 		pMemNode->pNext->pPrev = pMemNode;
+		LruAppend(pMemNode);
 
 		// free the new node
 		FreeMemNode(pNew);
@@ -460,6 +509,10 @@ void MemoryReAlloc(MEM_NODE *pMemNode, long size) {
 void MemoryTouch(MEM_NODE *pMemNode) {
 	// update the LRU time
 	pMemNode->lruTime = DwGetCurrentTime();
+
+	// and move the node to the end of the LRU list
+	LruRemove(pMemNode);
+	LruAppend(pMemNode);
 }
 
 uint8 *MemoryDeref(MEM_NODE *pMemNode) {
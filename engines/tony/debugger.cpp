@@ -31,6 +31,7 @@ Debugger::Debugger() : GUI::Debugger() {
 	DCmd_Register("continue",		WRAP_METHOD(Debugger, Cmd_Exit));
 	DCmd_Register("scene",			WRAP_METHOD(Debugger, Cmd_Scene));
 	DCmd_Register("dirty_rects",	WRAP_METHOD(Debugger, Cmd_DirtyRects));
+	DCmd_Register("processes",		WRAP_METHOD(Debugger, Cmd_Processes));
 }
 
 static int strToInt(const char *s) {
@@ -126,4 +127,22 @@ bool Debugger::Cmd_DirtyRects(int argc, const char **argv) {
 	}
 }
 
+/**
+ * Lists the running processes with their timing counters
+ */
+bool Debugger::Cmd_Processes(int argc, const char **argv) {
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		CoroScheduler.resetProcessStats();
+		return true;
+	} else if (argc != 1) {
+		DebugPrintf("Usage: %s [reset]\n", argv[0]);
+		DebugPrintf("Lists the processes with their timing counters, or resets the counters\n");
+		DebugPrintf("Times are measured in whole milliseconds, so short runs count as 0 ms\n");
+		return true;
+	}
+
+	DebugPrintf("%s", CoroScheduler.getProcessStats().c_str());
+	return true;
+}
+
 } // End of namespace Tony
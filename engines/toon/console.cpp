@@ -21,15 +21,79 @@
  */
 
 #include "toon/console.h"
+#include "toon/path.h"
+#include "toon/picture.h"
 #include "toon/toon.h"
 
+#include "common/system.h"
+
 namespace Toon {
 
 ToonConsole::ToonConsole(ToonEngine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+	DCmd_Register("benchmark_path", WRAP_METHOD(ToonConsole, Cmd_BenchmarkPath));
 }
 
 ToonConsole::~ToonConsole() {
 }
 
+/**
+ * Walk between pseudo random points of the current room like the characters
+ * do, and print how long the path finding took.
+ */
+bool ToonConsole::Cmd_BenchmarkPath(int argc, const char **argv) {
+	const int count = (argc > 1) ? MAX(1, atoi(argv[1])) : 100;
+
+	PathFinding *pathFinding = _vm->getPathFinding();
+	Picture *mask = _vm->getMask();
+	if (!mask || !mask->getDataPtr()) {
+		DebugPrintf("No room is loaded\n");
+		return true;
+	}
+
+	const int16 width = mask->getWidth();
+	const int16 height = mask->getHeight();
+
+	// The same requests on every run, so the timings can be compared
+	uint32 random = 12345;
+	int found = 0;
+	uint32 nodeCount = 0;
+	uint32 closestTime = 0;
+	uint32 pathTime = 0;
+
+	for (int i = 0; i < count; i++) {
+		int16 x, y, destX, destY;
+		random = random * 1103515245 + 12345;
+		x = (random >> 8) % width;
+		random = random * 1103515245 + 12345;
+		y = (random >> 8) % height;
+		if (!pathFinding->findClosestWalkingPoint(x, y, &x, &y)) {
+			DebugPrintf("The room has no walkable area\n");
+			return true;
+		}
+
+		random = random * 1103515245 + 12345;
+		const int16 clickX = (random >> 8) % width;
+		random = random * 1103515245 + 12345;
+		const int16 clickY = (random >> 8) % height;
+
+		uint32 start = g_system->getMillis();
+		pathFinding->findClosestWalkingPoint(clickX, clickY, &destX, &destY, x, y);
+		closestTime += g_system->getMillis() - start;
+
+		start = g_system->getMillis();
+		if (pathFinding->findPath(x, y, destX, destY)) {
+			found++;
+			nodeCount += pathFinding->getPathNodeCount();
+		}
+		pathTime += g_system->getMillis() - start;
+	}
+
+	DebugPrintf("%d walks in a %dx%d room, %d paths found with %d nodes\n",
+	            count, width, height, found, nodeCount);
+	DebugPrintf("Closest walking points: %d ms, paths: %d ms\n", closestTime, pathTime);
+	return true;
+}
+
 } // End of namespace Toon
@@ -35,6 +35,8 @@ public:
 	virtual ~ToonConsole(void);
 
 private:
+	bool Cmd_BenchmarkPath(int argc, const char **argv);
+
 	ToonEngine *_vm;
 };
 
@@ -151,6 +151,8 @@ PathFinding::PathFinding() {
 	_height = 0;
 	_heap = new PathFindingHeap();
 	_sq = NULL;
+	_regions = NULL;
+	_regionsRevision = 0;
 	_numBlockingRects = 0;
 }
 
@@ -159,6 +161,7 @@ PathFinding::~PathFinding(void) {
 		_heap->unload();
 	delete _heap;
 	delete[] _sq;
+	delete[] _regions;
 }
 
 void PathFinding::init(Picture *mask) {
@@ -171,6 +174,58 @@ void PathFinding::init(Picture *mask) {
 	_heap->init(500);
 	delete[] _sq;
 	_sq = new uint16[_width * _height];
+
+	delete[] _regions;
+	_regions = NULL;
+	updateRegions();
+}
+
+void PathFinding::updateRegions() {
+	if (_regions && _regionsRevision == _currentMask->getRevision())
+		return;
+
+	debugC(1, kDebugPath, "updateRegions()");
+
+	const int32 size = _width * _height;
+	if (!_regions)
+		_regions = new uint32[size];
+
+	const uint8 *mask = _currentMask->getDataPtr();
+	memset(_regions, 0, size * sizeof(uint32));
+	_regionsRevision = _currentMask->getRevision();
+
+	if (!mask)
+		return;
+
+	// Flood fill each walkable area with its own label, using the same
+	// 8-neighbourhood as the A* search in findPath().
+	Common::Array<int32> stack;
+	uint32 region = 0;
+	for (int32 start = 0; start < size; start++) {
+		if (_regions[start] || !(mask[start] & 0x1f))
+			continue;
+
+		region++;
+		_regions[start] = region;
+		stack.push_back(start);
+
+		while (!stack.empty()) {
+			const int32 node = stack.back();
+			stack.pop_back();
+
+			const int16 x = node % _width;
+			const int16 y = node / _width;
+			for (int16 py = MAX<int16>(y - 1, 0); py <= MIN<int16>(y + 1, _height - 1); py++) {
+				for (int16 px = MAX<int16>(x - 1, 0); px <= MIN<int16>(x + 1, _width - 1); px++) {
+					const int32 next = px + py * _width;
+					if (!_regions[next] && (mask[next] & 0x1f)) {
+						_regions[next] = region;
+						stack.push_back(next);
+					}
+				}
+			}
+		}
+	}
 }
 
 bool PathFinding::isLikelyWalkable(int16 x, int16 y) {
@@ -207,15 +262,33 @@ bool PathFinding::findClosestWalkingPoint(int16 xx, int16 yy, int16 *fxx, int16
 	if (origY == -1)
 		origY = yy;
 
-	for (int16 y = 0; y < _height; y++) {
-		for (int16 x = 0; x < _width; x++) {
-			if (isWalkable(x, y) && isLikelyWalkable(x, y)) {
+	// Search in square rings of growing size around the point. All points
+	// on ring r are at least r away, so the search can stop once r exceeds
+	// the distance of the closest point found. Ties are broken as if the
+	// whole mask was scanned row by row.
+	const int32 maxRing = MAX(MAX<int32>(xx, _width - 1 - xx), MAX<int32>(yy, _height - 1 - yy));
+	for (int32 r = 0; r <= maxRing && (currentFound < 0 || r * r <= dist); r++) {
+		const int32 top = MAX<int32>(yy - r, 0);
+		const int32 bottom = MIN<int32>(yy + r, _height - 1);
+		const int32 left = MAX<int32>(xx - r, 0);
+		const int32 right = MIN<int32>(xx + r, _width - 1);
+
+		for (int32 y = top; y <= bottom; y++) {
+			// Inner rows only contain the left and right end of the ring
+			const bool edgeRow = (y == yy - r || y == yy + r);
+			const int32 step = edgeRow ? 1 : 2 * r;
+
+			for (int32 x = edgeRow ? left : xx - r; x <= right; x += step) {
+				if (x < 0 || !isWalkable(x, y) || !isLikelyWalkable(x, y))
+					continue;
+
 				int32 ndist = (x - xx) * (x - xx) + (y - yy) * (y - yy);
 				int32 ndist2 = (x - origX) * (x - origX) + (y - origY) * (y - origY);
-				if (currentFound < 0 || ndist < dist || (ndist == dist && ndist2 < dist2)) {
+				int32 node = y * _width + x;
+				if (currentFound < 0 || ndist < dist || (ndist == dist && (ndist2 < dist2 || (ndist2 == dist2 && node < currentFound)))) {
 					dist = ndist;
 					dist2 = ndist2;
-					currentFound = y * _width + x;
+					currentFound = node;
 				}
 			}
 		}
@@ -303,6 +376,25 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 		return true;
 	}
 
+	// The search can only reach the walkable area containing the start
+	// point or those next to it. If the destination lies in none of them,
+	// there is no need to search the whole area to find that out.
+	updateRegions();
+
+	const uint32 destRegion = (destx < _width && desty < _height) ? _regions[destx + desty * _width] : 0;
+	bool reachable = false;
+	if (destRegion) {
+		for (int16 py = MAX<int16>(y - 1, 0); py <= MIN<int16>(y + 1, _height - 1) && !reachable; py++) {
+			for (int16 px = MAX<int16>(x - 1, 0); px <= MIN<int16>(x + 1, _width - 1) && !reachable; px++)
+				reachable = (_regions[px + py * _width] == destRegion);
+		}
+	}
+
+	if (!reachable) {
+		_tempPath.clear();
+		return false;
+	}
+
 	// no direct line, we use the standard A* algorithm
 	memset(_sq , 0, _width * _height * sizeof(uint16));
 	_heap->clear();
@@ -328,8 +420,8 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 				if (px != curX || py != curY) {
 					uint16 wei = abs(px - curX) + abs(py - curY);
 
-					if (isWalkable(px, py)) { // walkable ?
-						int32 curPNode = px + py * _width;
+					int32 curPNode = px + py * _width;
+					if (_regions[curPNode]) { // walkable ?
 						uint32 sum = _sq[curNode] + wei * (1 + (isLikelyWalkable(px, py) ? 5 : 0));
 						if (sum > (uint32)0xFFFF) {
 							warning("PathFinding::findPath sum exceeds maximum representable!");
@@ -381,7 +473,7 @@ bool PathFinding::findPath(int16 x, int16 y, int16 destx, int16 desty) {
 			for (int16 py = startY; py <= endY; py++) {
 				if (px != curX || py != curY) {
 					int32 PNode = px + py * _width;
-					if (_sq[PNode] && (isWalkable(px, py))) {
+					if (_sq[PNode] && _regions[PNode]) {
 						if (_sq[PNode] < bestscore) {
 							bestscore = _sq[PNode];
 							bestX = px;
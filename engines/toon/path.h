@@ -84,6 +84,16 @@ private:
 
 	PathFindingHeap *_heap;
 
+	/**
+	 * Labels the connected walkable areas of the mask, if it changed since
+	 * they were labeled last.
+	 */
+	void updateRegions();
+
+	// Walkable area each pixel of the mask belongs to, 0 if not walkable
+	uint32 *_regions;
+	uint32 _regionsRevision;
+
 	uint16 *_sq;
 	int16 _width;
 	int16 _height;
@@ -134,6 +134,7 @@ bool Picture::loadPicture(const Common::String &file) {
 Picture::Picture(ToonEngine *vm) : _vm(vm) {
 	_data = NULL;
 	_palette = NULL;
+	_revision = 0;
 }
 
 Picture::~Picture() {
@@ -260,6 +261,7 @@ uint8 Picture::getData(int16 x, int16 y) {
 // use original work from johndoe
 void Picture::floodFillNotWalkableOnMask(int16 x, int16 y) {
 	debugC(1, kDebugPicture, "floodFillNotWalkableOnMask(%d, %d)", x, y);
+	_revision++;
 	// Stack-based floodFill algorithm based on
 	// http://student.kuleuven.be/~m0216922/CG/files/floodfill.cpp
 	Common::Stack<Common::Point> stack;
@@ -293,6 +295,7 @@ void Picture::floodFillNotWalkableOnMask(int16 x, int16 y) {
 
 void Picture::drawLineOnMask(int16 x, int16 y, int16 x2, int16 y2, bool walkable) {
 	debugC(1, kDebugPicture, "drawLineOnMask(%d, %d, %d, %d, %d)", x, y, x2, y2, (walkable) ? 1 : 0);
+	_revision++;
 	static int16 lastX = 0;
 	static int16 lastY = 0;
 
@@ -51,10 +51,17 @@ public:
 	int16 getWidth() const { return _width; }
 	int16 getHeight() const { return _height; }
 
+	/**
+	 * Returns a number which changes whenever the walkable area of the mask
+	 * is modified, so that data derived from it can be updated.
+	 */
+	uint32 getRevision() const { return _revision; }
+
 protected:
 	int16 _width;
 	int16 _height;
 	uint8 *_data;
+	uint32 _revision;
 	uint8 *_palette; // need to be copied at 3-387
 	int32 _paletteEntries;
 	bool _useFullPalette;
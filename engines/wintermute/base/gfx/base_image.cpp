@@ -81,12 +81,12 @@ bool BaseImage::loadFile(const Common::String &filename) {
 		return false;
 	}
 
-	_decoder->loadStream(*file);
+	const bool success = _decoder->loadStream(*file);
 	_surface = _decoder->getSurface();
 	_palette = _decoder->getPalette();
 	_fileManager->closeFile(file);
 
-	return true;
+	return success;
 }
 
 byte BaseImage::getAlphaAt(int x, int y) const {
@@ -58,7 +58,11 @@ void PNGDecoder::destroy() {
 #ifdef USE_PNG
 // libpng-error-handling:
 void pngError(png_structp pngptr, png_const_charp errorMsg) {
-	error("%s", errorMsg);
+	// Report the error, and continue after the setjmp() in loadStream(),
+	// which makes it fail. This may be called from other threads than the
+	// main one, so it must not call error().
+	warning("%s", errorMsg);
+	longjmp(png_jmpbuf(pngptr), 1);
 }
 
 void pngWarning(png_structp pngptr, png_const_charp warningMsg) {
@@ -90,11 +94,11 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 
 	// First, check the PNG signature
 	if (_stream->readUint32BE() != MKTAG(0x89, 'P', 'N', 'G')) {
-		delete _stream;
+		_stream = 0;
 		return false;
 	}
 	if (_stream->readUint32BE() != MKTAG(0x0d, 0x0a, 0x1a, 0x0a)) {
-		delete _stream;
+		_stream = 0;
 		return false;
 	}
 
@@ -104,24 +108,34 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	// along with the png-loading code used in the sword25-engine.
 	png_structp pngPtr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
 	if (!pngPtr) {
-		delete _stream;
+		_stream = 0;
 		return false;
 	}
 	png_infop infoPtr = png_create_info_struct(pngPtr);
 	if (!infoPtr) {
 		png_destroy_read_struct(&pngPtr, NULL, NULL);
-		delete _stream;
+		_stream = 0;
 		return false;
 	}
 	png_infop endInfo = png_create_info_struct(pngPtr);
 	if (!endInfo) {
 		png_destroy_read_struct(&pngPtr, &infoPtr, NULL);
-		delete _stream;
+		_stream = 0;
 		return false;
 	}
 
+	// Row pointers of interlaced images, which have to be freed on errors
+	png_bytep *volatile rowPtr = 0;
+
 	png_set_error_fn(pngPtr, NULL, pngError, pngWarning);
-	// TODO: The manual says errors should be handled via setjmp
+	// libpng continues here when it encounters an error, see pngError()
+	if (setjmp(png_jmpbuf(pngPtr))) {
+		png_destroy_read_struct(&pngPtr, &infoPtr, &endInfo);
+		delete[] rowPtr;
+		destroy();
+		_stream = 0;
+		return false;
+	}
 
 	png_set_read_fn(pngPtr, _stream, pngReadFromStream);
 	png_set_crc_action(pngPtr, PNG_CRC_DEFAULT, PNG_CRC_WARN_USE);
@@ -149,7 +163,9 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 		png_colorp palette = NULL;
 		uint32 success = png_get_PLTE(pngPtr, infoPtr, &palette, &numPalette);
 		if (success != PNG_INFO_PLTE) {
-			png_destroy_read_struct(&pngPtr, &infoPtr, NULL);
+			png_destroy_read_struct(&pngPtr, &infoPtr, &endInfo);
+			destroy();
+			_stream = 0;
 			return false;
 		}
 		_paletteColorCount = numPalette;
@@ -164,9 +180,8 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 		png_set_packing(pngPtr);
 	} else {
 		_outputSurface->create(width, height, Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0));
-		if (!_outputSurface->pixels) {
-			error("Could not allocate memory for output image.");
-		}
+		if (!_outputSurface->pixels)
+			png_error(pngPtr, "Could not allocate memory for output image.");
 		if (bitDepth == 16)
 			png_set_strip_16(pngPtr);
 		if (bitDepth < 8)
@@ -207,10 +222,7 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 		// buffer with pointers to all row starts.
 
 		// Allocate row pointer buffer
-		png_bytep *rowPtr = new png_bytep[height];
-		if (!rowPtr) {
-			error("Could not allocate memory for row pointers.");
-		}
+		rowPtr = new png_bytep[height];
 
 		// Initialize row pointers
 		for (int i = 0; i < height; i++)
@@ -221,6 +233,7 @@ bool PNGDecoder::loadStream(Common::SeekableReadStream &stream) {
 
 		// Free row pointer buffer
 		delete[] rowPtr;
+		rowPtr = 0;
 	}
 
 	// Read additional data at the end.
@@ -19,12 +19,14 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/system.h"
 #include "common/taskbar.h"
+#include "common/timer.h"
 #include "common/translation.h"
 
 #include "gui/launcher.h"	// For addGameToConf()
@@ -47,7 +49,16 @@ enum {
 	// Upper bound (im milliseconds) we want to spend in handleTickle.
 	// Setting this low makes the GUI more responsive but also slows
 	// down the scanning.
-	kMaxScanTime = 50
+	kMaxScanTime = 50,
+
+	// Interval and upper bound (in milliseconds) of the directory walker,
+	// which lists directories from a timer callback while handleTickle runs
+	// the detection on them.
+	kWalkInterval = 10,
+	kMaxWalkTime = 8,
+
+	// Maximum number of listed directories waiting for detection
+	kMaxPendingDirs = 256
 };
 
 enum {
@@ -59,6 +70,9 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
+	_walkerBusy(false),
+	_walking(false),
+	_scanDone(false),
 	_dirsScanned(0),
 	_oldGamesCount(0),
 	_dirTotal(0),
@@ -68,8 +82,14 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 
 	StringArray l;
 
-	// The dir we start our scan at
-	_scanStack.push(startDir);
+	// The dir we start our scan at. The walker only works on nodes not
+	// shared with anybody else, since FSNode is not thread safe.
+	_scanStack.push(Common::FSNode(Common::String(startDir.getPath().c_str())));
+
+	// Keep the detection cache in scan mode for all directories, so the
+	// index is only written once the whole scan is done
+	DetectionCache::instance().beginScan();
+	_scanStartTime = g_system->getMillis();
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -116,6 +136,72 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 		if (!path.empty())
 			_pathToTargets[path].push_back(iter->_key);
 	}
+
+	_walking = g_system->getTimerManager()->installTimerProc(&walkProc, kWalkInterval * 1000, this, "MassAddDialog");
+}
+
+MassAddDialog::~MassAddDialog() {
+	stopWalking();
+
+	// The scan was cancelled before it was complete
+	if (!_scanDone)
+		DetectionCache::instance().endScan();
+}
+
+void MassAddDialog::walkProc(void *refCon) {
+	((MassAddDialog *)refCon)->walkDirectories(kMaxWalkTime);
+}
+
+void MassAddDialog::stopWalking() {
+	if (_walking) {
+		g_system->getTimerManager()->removeTimerProc(&walkProc);
+		_walking = false;
+	}
+}
+
+void MassAddDialog::walkDirectories(uint32 maxTime) {
+	const uint32 start = g_system->getMillis();
+
+	do {
+		Common::FSNode dir;
+		{
+			Common::StackLock lock(_mutex);
+			if (_scanStack.empty() || _pendingDirs.size() >= kMaxPendingDirs)
+				return;
+
+			dir = _scanStack.pop();
+			_walkerBusy = true;
+		}
+
+		ScanResult result;
+		result.dir = dir;
+		if (!dir.getChildren(result.files, Common::FSNode::kListAll)) {
+			Common::StackLock lock(_mutex);
+			_walkerBusy = false;
+			continue;
+		}
+
+		// Use fresh nodes for the subdirectories, so the nodes handed over
+		// to the detection do not share any data with the ones we keep.
+		Common::FSList subdirs;
+		for (Common::FSList::const_iterator file = result.files.begin(); file != result.files.end(); ++file) {
+			if (file->isDirectory())
+				subdirs.push_back(Common::FSNode(Common::String(file->getPath().c_str())));
+		}
+
+		Common::StackLock lock(_mutex);
+		for (Common::FSList::const_iterator subdir = subdirs.begin(); subdir != subdirs.end(); ++subdir)
+			_scanStack.push(*subdir);
+		_dirTotal += subdirs.size();
+		_pendingDirs.push(result);
+		_walkerBusy = false;
+
+		// Release our references while still holding the lock, from now on
+		// the listed nodes belong to handleTickle.
+		result.files.clear();
+		result.dir = Common::FSNode();
+		dir = Common::FSNode();
+	} while (g_system->getMillis() - start < maxTime);
 }
 
 struct GameTargetLess {
@@ -163,6 +249,7 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 		close();
 	} else if (cmd == kCancelCmd) {
 		// User cancelled, so we don't do anything and just leave.
+		stopWalking();
 		_games.clear();
 		close();
 	} else {
@@ -170,79 +257,85 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 	}
 }
 
-void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
-		return;	// We have finished scanning
+void MassAddDialog::detectGames(const ScanResult &scan) {
+	const Common::FSNode &dir = scan.dir;
 
-	uint32 t = g_system->getMillis();
+	// Run the detector on the dir
+	GameList candidates(EngineMan.detectGames(scan.files));
 
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		GameDescriptor result = *cand;
+		Common::String path = dir.getPath();
 
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
-		}
+		// Remove trailing slashes
+		while (path != "/" && path.lastChar() == '/')
+			path.deleteLastChar();
 
-		// Run the detector on the dir
-		GameList candidates(EngineMan.detectGames(files));
-
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			GameDescriptor result = *cand;
-			Common::String path = dir.getPath();
-
-			// Remove trailing slashes
-			while (path != "/" && path.lastChar() == '/')
-				path.deleteLastChar();
-
-			// Check for existing config entries for this path/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				bool duplicate = false;
-				const StringArray &targets = _pathToTargets[path];
-				for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((*dom)["gameid"] == result["gameid"] &&
-					    (*dom)["platform"] == result["platform"] &&
-					    (*dom)["language"] == result["language"]) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					break;	// Skip duplicates
+		// Check for existing config entries for this path/gameid/lang/platform combination
+		if (_pathToTargets.contains(path)) {
+			bool duplicate = false;
+			const StringArray &targets = _pathToTargets[path];
+			for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+				// If the gameid, platform and language match -> skip it
+				Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+				assert(dom);
+
+				if ((*dom)["gameid"] == result["gameid"] &&
+				    (*dom)["platform"] == result["platform"] &&
+				    (*dom)["language"] == result["language"]) {
+					duplicate = true;
+					break;
 				}
 			}
-			result["path"] = path;
-			_games.push_back(result);
-
-			_list->append(result.description());
+			if (duplicate) {
+				_oldGamesCount++;
+				break;	// Skip duplicates
+			}
 		}
+		result["path"] = path;
+		_games.push_back(result);
 
+		_list->append(result.description());
+	}
+}
+
+void MassAddDialog::handleTickle() {
+	if (_scanDone)
+		return;
 
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
+	uint32 t = g_system->getMillis();
 
-				_dirTotal++;
+	// Without the timer, the directories have to be listed here
+	if (!_walking)
+		walkDirectories(kMaxScanTime / 2);
+
+	// Run the detection on the directories listed so far
+	int dirTotal = 0;
+	bool done = false;
+	while ((g_system->getMillis() - t) < kMaxScanTime) {
+		ScanResult scan;
+		{
+			Common::StackLock lock(_mutex);
+			dirTotal = _dirTotal;
+			if (_pendingDirs.empty()) {
+				done = _scanStack.empty() && !_walkerBusy;
+				break;
 			}
+			scan = _pendingDirs.pop();
 		}
 
+		detectGames(scan);
+
 		_dirsScanned++;
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
+		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, dirTotal);
 		g_system->getTaskbarManager()->setCount(_games.size());
 #endif
 	}
@@ -251,7 +344,18 @@ void MassAddDialog::handleTickle() {
 	// Update the dialog
 	Common::String buf;
 
-	if (_scanStack.empty()) {
+	if (done) {
+		stopWalking();
+		_scanDone = true;
+
+		DetectionCache::instance().endScan();
+
+		const uint32 time = MAX<uint32>(g_system->getMillis() - _scanStartTime, 1);
+		const DetectionCache::Stats &stats = DetectionCache::instance().getStats();
+		debug(1, "MassAddDialog: Scanned %d directories in %u ms (%u per second), hashed %u files (%u per second)",
+		      _dirsScanned, time, _dirsScanned * 1000 / time,
+		      stats.files - stats.hits, (stats.files - stats.hits) * 1000 / time);
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
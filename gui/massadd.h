@@ -25,6 +25,8 @@
 #include "gui/dialog.h"
 #include "common/fs.h"
 #include "common/hashmap.h"
+#include "common/mutex.h"
+#include "common/queue.h"
 #include "common/stack.h"
 #include "common/str.h"
 
@@ -36,6 +38,7 @@ class MassAddDialog : public Dialog {
 	typedef Common::Array<Common::String> StringArray;
 public:
 	MassAddDialog(const Common::FSNode &startDir);
+	~MassAddDialog();
 
 	//void open();
 	void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
@@ -48,7 +51,36 @@ public:
 	}
 
 private:
+	/** A directory listed by the walker, waiting to be run through detection. */
+	struct ScanResult {
+		Common::FSNode dir;
+		Common::FSList files;
+	};
+
+	static void walkProc(void *refCon);
+
+	/**
+	 * List directories from the scan stack for at most maxTime milliseconds,
+	 * and queue them for detection.
+	 */
+	void walkDirectories(uint32 maxTime);
+	void stopWalking();
+	void detectGames(const ScanResult &result);
+
+	/**
+	 * Guards the members shared with the walker, which runs from a timer
+	 * callback: _scanStack, _pendingDirs, _walkerBusy and _dirTotal.
+	 */
+	Common::Mutex _mutex;
 	Common::Stack<Common::FSNode>  _scanStack;
+	Common::Queue<ScanResult> _pendingDirs;
+	bool _walkerBusy;
+
+	/** Whether the walker runs from a timer, otherwise handleTickle() runs it */
+	bool _walking;
+	bool _scanDone;
+	uint32 _scanStartTime;
+
 	GameList _games;
 
 	/**
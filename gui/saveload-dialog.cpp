@@ -22,6 +22,11 @@
 #include "gui/saveload-dialog.h"
 #include "common/translation.h"
 #include "common/config-manager.h"
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/savefile.h"
+#include "common/singleton.h"
+#include "common/system.h"
 
 #include "gui/message.h"
 #include "gui/gui-manager.h"
@@ -31,6 +36,136 @@
 #include "graphics/scaler.h"
 
 namespace GUI {
+class SaveMetaCache;
+}
+
+namespace Common {
+DECLARE_SINGLETON(GUI::SaveMetaCache);
+}
+
+namespace GUI {
+
+/**
+ * Cache of the save state meta infos of the last target shown, so that
+ * opening a chooser again does not read all savefiles again. It is cleared
+ * whenever a savefile is written or removed, and when the modification
+ * time or size of any file in the save path changed since it was filled.
+ */
+class SaveMetaCache : public Common::Singleton<SaveMetaCache> {
+public:
+	/**
+	 * Return the meta infos of a save state, reading them from the savefile
+	 * only if they are not cached.
+	 */
+	SaveStateDescriptor query(const MetaEngine &metaEngine, const Common::String &target, int slot);
+
+	/** Return whether the meta infos of a save state are cached. */
+	bool isCached(const Common::String &target, int slot);
+
+	/**
+	 * Drop the cached meta infos if any savefile was changed behind the
+	 * save file manager's back, e.g. by another program.
+	 */
+	void checkSavefiles(const Common::String &target);
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	SaveMetaCache() : _revision(0) {}
+
+	struct FileState {
+		uint32 modificationTime;
+		int32 size;
+	};
+
+	typedef Common::HashMap<int, SaveStateDescriptor> DescriptorMap;
+	typedef Common::HashMap<Common::String, FileState> FileStateMap;
+
+	/**
+	 * Drop the cached meta infos if they do not belong to target in the
+	 * current save path anymore.
+	 */
+	void validate(const Common::String &target);
+	void reset(const Common::String &savePath, const Common::String &target, uint32 revision);
+	/** Record the state of all files in the save path. */
+	void scanSavefiles(FileStateMap &files) const;
+
+	Common::String _savePath;
+	Common::String _target;
+	uint32 _revision;
+	DescriptorMap _descriptors;
+	/** State of the files in the save path when the cache was reset */
+	FileStateMap _files;
+};
+
+SaveStateDescriptor SaveMetaCache::query(const MetaEngine &metaEngine, const Common::String &target, int slot) {
+	validate(target);
+
+	DescriptorMap::const_iterator i = _descriptors.find(slot);
+	if (i != _descriptors.end())
+		return i->_value;
+
+	SaveStateDescriptor desc = metaEngine.querySaveMetaInfos(target.c_str(), slot);
+	// Without a revision, changes to the savefiles can not be detected.
+	if (_revision)
+		_descriptors[slot] = desc;
+	return desc;
+}
+
+bool SaveMetaCache::isCached(const Common::String &target, int slot) {
+	validate(target);
+	return _descriptors.contains(slot);
+}
+
+void SaveMetaCache::checkSavefiles(const Common::String &target) {
+	validate(target);
+	if (_descriptors.empty())
+		return;
+
+	FileStateMap files;
+	scanSavefiles(files);
+
+	bool changed = (files.size() != _files.size());
+	for (FileStateMap::const_iterator i = files.begin(); i != files.end() && !changed; ++i) {
+		FileStateMap::const_iterator old = _files.find(i->_key);
+		changed = (old == _files.end()
+		           || old->_value.modificationTime != i->_value.modificationTime
+		           || old->_value.size != i->_value.size);
+	}
+
+	if (changed) {
+		_descriptors.clear();
+		_files = files;
+	}
+}
+
+void SaveMetaCache::validate(const Common::String &target) {
+	const Common::String savePath = ConfMan.get("savepath");
+	const uint32 revision = g_system->getSavefileManager()->getRevision();
+	if (revision != _revision || target != _target || savePath != _savePath)
+		reset(savePath, target, revision);
+}
+
+void SaveMetaCache::reset(const Common::String &savePath, const Common::String &target, uint32 revision) {
+	_descriptors.clear();
+	_savePath = savePath;
+	_target = target;
+	_revision = revision;
+
+	_files.clear();
+	scanSavefiles(_files);
+}
+
+void SaveMetaCache::scanSavefiles(FileStateMap &files) const {
+	Common::FSList list;
+	if (_savePath.empty() || !Common::FSNode(_savePath).getChildren(list, Common::FSNode::kListFilesOnly))
+		return;
+
+	for (Common::FSList::const_iterator i = list.begin(); i != list.end(); ++i) {
+		FileState &state = files[i->getName()];
+		state.modificationTime = i->getModificationTime();
+		state.size = i->getFileSize();
+	}
+}
 
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 SaveLoadChooserType getRequestedSaveLoadDialog(const MetaEngine &metaEngine) {
@@ -104,9 +239,19 @@ int SaveLoadChooserDialog::run(const Common::String &target, const MetaEngine *m
 	_saveDateSupport = _metaInfoSupport && _metaEngine->hasFeature(MetaEngine::kSavesSupportCreationDate);
 	_playTimeSupport = _metaInfoSupport && _metaEngine->hasFeature(MetaEngine::kSavesSupportPlayTime);
 
+	SaveMetaCache::instance().checkSavefiles(_target);
+
 	return runIntern();
 }
 
+SaveStateDescriptor SaveLoadChooserDialog::querySaveMetaInfos(int slot) const {
+	return SaveMetaCache::instance().query(*_metaEngine, _target, slot);
+}
+
+bool SaveLoadChooserDialog::hasSaveMetaInfos(int slot) const {
+	return SaveMetaCache::instance().isCached(_target, slot);
+}
+
 void SaveLoadChooserDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data) {
 #ifndef DISABLE_SAVELOADCHOOSER_GRID
 	switch (cmd) {
@@ -360,7 +505,7 @@ void SaveLoadChooserSimple::updateSelection(bool redraw) {
 	_playtime->setLabel(_("No playtime saved"));
 
 	if (selItem >= 0 && _metaInfoSupport) {
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), _saveList[selItem].getSaveSlot());
+		SaveStateDescriptor desc = querySaveMetaInfos(_saveList[selItem].getSaveSlot());
 
 		isDeletable = desc.getDeletableFlag() && _delSupport;
 		isWriteProtected = desc.getWriteProtectedFlag();
@@ -842,6 +987,7 @@ void SaveLoadChooserGrid::hideButtons() {
 	for (ButtonArray::iterator i = _buttons.begin(), end = _buttons.end(); i != end; ++i) {
 		i->button->setGfx(0);
 		i->setVisible(false);
+		i->metaInfoPending = false;
 	}
 }
 
@@ -850,52 +996,22 @@ void SaveLoadChooserGrid::updateSaves() {
 
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
 		const uint saveSlot = _saveList[i].getSaveSlot();
-
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot);
 		SlotButton &curButton = _buttons[curNum];
 		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
-		}
-		curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, desc.getDescription().c_str()));
-
-		Common::String tooltip(_("Name: "));
-		tooltip += desc.getDescription();
 
-		if (_saveDateSupport) {
-			const Common::String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += "\n";
-				tooltip +=  _("Date: ") + saveDate;
-			}
-
-			const Common::String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Time: ") + saveTime;
-			}
-		}
-
-		if (_playTimeSupport) {
-			const Common::String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Playtime: ") + playTime;
-			}
+		if (hasSaveMetaInfos(saveSlot)) {
+			updateSlotButton(curButton, saveSlot, querySaveMetaInfos(saveSlot));
+			continue;
 		}
 
-		curButton.button->setTooltip(tooltip);
-
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		if (_saveMode && desc.getWriteProtectedFlag()) {
-			curButton.button->setEnabled(false);
-		} else {
-			curButton.button->setEnabled(true);
-		}
+		// Reading the meta infos requires opening the savefile, so show the
+		// listed description for now and read them in handleTickle.
+		curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+		curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, _saveList[i].getDescription().c_str()));
+		curButton.button->setTooltip(_("Name: ") + _saveList[i].getDescription());
+		// Write protection is not known yet.
+		curButton.button->setEnabled(!_saveMode);
+		curButton.metaInfoPending = true;
 	}
 
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
@@ -912,6 +1028,71 @@ void SaveLoadChooserGrid::updateSaves() {
 		_nextButton->setEnabled(false);
 }
 
+void SaveLoadChooserGrid::updateSlotButton(SlotButton &curButton, uint saveSlot, const SaveStateDescriptor &desc) {
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (thumbnail) {
+		curButton.button->setGfx(thumbnail);
+	} else {
+		curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, desc.getDescription().c_str()));
+
+	Common::String tooltip(_("Name: "));
+	tooltip += desc.getDescription();
+
+	if (_saveDateSupport) {
+		const Common::String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += "\n";
+			tooltip +=  _("Date: ") + saveDate;
+		}
+
+		const Common::String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Time: ") + saveTime;
+		}
+	}
+
+	if (_playTimeSupport) {
+		const Common::String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Playtime: ") + playTime;
+		}
+	}
+
+	curButton.button->setTooltip(tooltip);
+
+	// In save mode we disable the button, when it's write protected.
+	// TODO: Maybe we should not display it at all then?
+	if (_saveMode && desc.getWriteProtectedFlag()) {
+		curButton.button->setEnabled(false);
+	} else {
+		curButton.button->setEnabled(true);
+	}
+
+	curButton.metaInfoPending = false;
+}
+
+void SaveLoadChooserGrid::handleTickle() {
+	// Read the meta infos of one slot per tick, so the dialog stays
+	// responsive while the thumbnails are filled in.
+	for (uint curNum = 0; curNum < _buttons.size(); ++curNum) {
+		SlotButton &curButton = _buttons[curNum];
+		if (!curButton.metaInfoPending)
+			continue;
+
+		const uint saveSlot = _saveList[_curPage * _entriesPerPage + curNum].getSaveSlot();
+		updateSlotButton(curButton, saveSlot, querySaveMetaInfos(saveSlot));
+		curButton.button->draw();
+		curButton.description->draw();
+		break;
+	}
+
+	SaveLoadChooserDialog::handleTickle();
+}
+
 SavenameDialog::SavenameDialog()
 	: Dialog("SavenameDialog") {
 	_title = new StaticTextWidget(this, "SavenameDialog.DescriptionText", Common::String());
@@ -69,6 +69,15 @@ public:
 protected:
 	virtual int runIntern() = 0;
 
+	/**
+	 * Return the meta infos of a save state of the current target. They are
+	 * cached, so that choosers opened later do not read them again.
+	 */
+	SaveStateDescriptor querySaveMetaInfos(int slot) const;
+
+	/** Return whether querySaveMetaInfos() can be answered from the cache. */
+	bool hasSaveMetaInfos(int slot) const;
+
 	const bool				_saveMode;
 	const MetaEngine		*_metaEngine;
 	bool					_delSupport;
@@ -163,6 +172,7 @@ public:
 protected:
 	virtual void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
 	virtual void handleMouseWheel(int x, int y, int direction);
+	virtual void handleTickle();
 private:
 	virtual int runIntern();
 
@@ -184,12 +194,14 @@ private:
 	bool selectDescription();
 
 	struct SlotButton {
-		SlotButton() : container(0), button(0), description(0) {}
-		SlotButton(ContainerWidget *c, PicButtonWidget *b, StaticTextWidget *d) : container(c), button(b), description(d) {}
+		SlotButton() : container(0), button(0), description(0), metaInfoPending(false) {}
+		SlotButton(ContainerWidget *c, PicButtonWidget *b, StaticTextWidget *d) : container(c), button(b), description(d), metaInfoPending(false) {}
 
 		ContainerWidget  *container;
 		PicButtonWidget  *button;
 		StaticTextWidget *description;
+		/** Whether the meta infos are still to be read in handleTickle */
+		bool metaInfoPending;
 
 		void setVisible(bool state) {
 			container->setVisible(state);
@@ -200,6 +212,7 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+	void updateSlotButton(SlotButton &curButton, uint saveSlot, const SaveStateDescriptor &desc);
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
@@ -81,4 +81,60 @@ class BufferedSeekableReadStreamTestSuite : public CxxTest::TestSuite {
 
 		delete &ssrs;
 	}
+
+	void test_random_access() {
+		byte contents[1000];
+		for (int i = 0; i < 1000; ++i)
+			contents[i] = i * 7;
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapBufferedSeekableReadStream(&ms, 16, DisposeAfterUse::NO);
+
+		// Jump around, reading across block boundaries, and compare with
+		// the unbuffered data.
+		uint32 offset = 3;
+		for (int i = 0; i < 200; ++i) {
+			offset = (offset * 37 + 11) % 1000;
+			const uint32 length = MIN<uint32>(1 + i % 70, 1000 - offset);
+
+			byte buf[70];
+			ssrs.seek(offset, SEEK_SET);
+			TS_ASSERT_EQUALS(ssrs.read(buf, length), length);
+			TS_ASSERT_EQUALS(memcmp(buf, contents + offset, length), 0);
+			TS_ASSERT_EQUALS((uint32)ssrs.pos(), offset + length);
+			TS_ASSERT(!ssrs.eos());
+		}
+
+		// Reading across the end of the data
+		byte buf[10];
+		ssrs.seek(-4, SEEK_END);
+		TS_ASSERT_EQUALS(ssrs.read(buf, 10), 4u);
+		TS_ASSERT_EQUALS(memcmp(buf, contents + 996, 4), 0);
+		TS_ASSERT(ssrs.eos());
+
+		delete &ssrs;
+	}
+
+	void test_revisit() {
+		byte contents[256];
+		for (int i = 0; i < 256; ++i)
+			contents[i] = i;
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		Common::SeekableReadStream &ssrs
+			= *Common::wrapBufferedSeekableReadStream(&ms, 32, DisposeAfterUse::NO);
+
+		// Alternating between two distant places only reads each once
+		const uint64 fetched = Common::getBufferedReadStats().bytesFetched;
+		for (int i = 0; i < 10; ++i) {
+			ssrs.seek(8, SEEK_SET);
+			TS_ASSERT_EQUALS(ssrs.readByte(), 8);
+			ssrs.seek(200, SEEK_SET);
+			TS_ASSERT_EQUALS(ssrs.readByte(), 200);
+		}
+		TS_ASSERT_EQUALS(Common::getBufferedReadStats().bytesFetched - fetched, 64u);
+
+		delete &ssrs;
+	}
 };
@@ -0,0 +1,66 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/memstream.h"
+
+#include "testsystem.h"
+
+#include <stdio.h>
+
+class MappedReadStreamTestSuite : public CxxTest::TestSuite
+{
+	static Common::FSNode writeFile(const char *name, uint32 size) {
+		Common::FSNode node = Common::FSNode(".").getChild(name);
+		Common::WriteStream *stream = node.createWriteStream();
+		for (uint32 i = 0; i < size; ++i)
+			stream->writeByte((byte)(i * 13 + (i >> 9)));
+		stream->finalize();
+		delete stream;
+		return Common::FSNode(".").getChild(name);
+	}
+
+public:
+	void setUp() {
+		TestSystem::install();
+	}
+
+	void test_same_content() {
+		Common::FSNode node = writeFile("mappedreadstream.tmp", 100000);
+
+		Common::MemoryReadStream *mapped = node.createMappedReadStream();
+		Common::SeekableReadStream *stream = node.createReadStream();
+		TS_ASSERT(mapped);
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS(mapped->size(), stream->size());
+
+		// The data can be accessed in place, and read like the file
+		const byte *data = mapped->getData();
+		byte buffer[1000];
+		for (int32 pos = 0; pos < stream->size(); pos += sizeof(buffer)) {
+			TS_ASSERT_EQUALS(stream->read(buffer, sizeof(buffer)), sizeof(buffer));
+			TS_ASSERT(!memcmp(data + pos, buffer, sizeof(buffer)));
+		}
+
+		stream->seek(-5000, SEEK_END);
+		mapped->seek(-5000, SEEK_END);
+		TS_ASSERT_EQUALS(mapped->pos(), stream->pos());
+		for (int i = 0; i < 5000; ++i)
+			TS_ASSERT_EQUALS(mapped->readByte(), stream->readByte());
+		mapped->readByte();
+		TS_ASSERT(mapped->eos());
+
+		delete mapped;
+		delete stream;
+		remove(node.getPath().c_str());
+	}
+
+	void test_unmappable() {
+		// Empty files, directories and missing files cannot be mapped
+		Common::FSNode empty = writeFile("mappedreadstream-empty.tmp", 0);
+		TS_ASSERT(!empty.createMappedReadStream());
+		remove(empty.getPath().c_str());
+
+		TS_ASSERT(!Common::FSNode(".").createMappedReadStream());
+		TS_ASSERT(!Common::FSNode(".").getChild("mappedreadstream-missing.tmp").createMappedReadStream());
+	}
+};
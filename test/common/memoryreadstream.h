@@ -100,4 +100,14 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_get_data() {
+		byte contents[] = { 1, 2, 3, 4, 5, 6, 7 };
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		// The data is accessed in place, independent of the position
+		ms.seek(4, SEEK_SET);
+		TS_ASSERT_EQUALS(ms.getData(), contents);
+		TS_ASSERT_EQUALS(ms.readByte(), 5);
+	}
 };
@@ -28,4 +28,18 @@ class MemoryWriteStreamTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT(memcmp(buffer, data, sizeof(data)) == 0);
 		TS_ASSERT(!stream.err());
 	}
+
+	void test_write_dynamic() {
+		Common::MemoryWriteStreamDynamic stream(DisposeAfterUse::YES);
+
+		for (uint i = 0; i < 10000; ++i)
+			stream.writeUint16LE(i);
+		TS_ASSERT_EQUALS(stream.size(), 20000u);
+		TS_ASSERT_EQUALS(stream.pos(), 20000u);
+
+		const byte *data = stream.getData();
+		TS_ASSERT_EQUALS(READ_LE_UINT16(data), 0);
+		TS_ASSERT_EQUALS(READ_LE_UINT16(data + 2 * 1234), 1234);
+		TS_ASSERT_EQUALS(READ_LE_UINT16(data + 2 * 9999), 9999);
+	}
 };
@@ -0,0 +1,71 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/profiler.h"
+
+static uint64 s_profilerClock = 0;
+
+static uint64 getProfilerTestClock() {
+	return s_profilerClock;
+}
+
+class ProfilerTestSuite : public CxxTest::TestSuite {
+	public:
+	void test_inactive() {
+		s_profilerClock = 0;
+		TS_ASSERT(!Common::Profiler::isActive());
+
+		{
+			Common::ProfileScope scope(Common::kProfileScript);
+			s_profilerClock += 10;
+		}
+
+		TS_ASSERT_EQUALS(Common::Profiler::instance().getCalls(Common::kProfileScript), 0u);
+	}
+
+	void test_nesting() {
+		Common::Profiler &profiler = Common::Profiler::instance();
+		s_profilerClock = 1000;
+		profiler.start(&getProfilerTestClock);
+
+		s_profilerClock += 5;
+		{
+			Common::ProfileScope script(Common::kProfileScript);
+			s_profilerClock += 20;
+			{
+				Common::ProfileScope file(Common::kProfileResource);
+				s_profilerClock += 7;
+			}
+			s_profilerClock += 3;
+		}
+		s_profilerClock += 1;
+		{
+			Common::ProfileScope file(Common::kProfileResource);
+			s_profilerClock += 2;
+		}
+
+		profiler.stop();
+		TS_ASSERT(!Common::Profiler::isActive());
+
+		TS_ASSERT_EQUALS(profiler.getTime(Common::kProfileEngine), 6u);
+		TS_ASSERT_EQUALS(profiler.getTime(Common::kProfileScript), 23u);
+		TS_ASSERT_EQUALS(profiler.getTime(Common::kProfileResource), 9u);
+		TS_ASSERT_EQUALS(profiler.getCalls(Common::kProfileScript), 1u);
+		TS_ASSERT_EQUALS(profiler.getCalls(Common::kProfileResource), 2u);
+		TS_ASSERT_EQUALS(profiler.getTotalTime(), 38u);
+
+		// Time passing after stop() is not accounted anymore
+		s_profilerClock += 100;
+		TS_ASSERT_EQUALS(profiler.getTotalTime(), 38u);
+	}
+
+	void test_restart() {
+		Common::Profiler &profiler = Common::Profiler::instance();
+		s_profilerClock = 0;
+		profiler.start(&getProfilerTestClock);
+		s_profilerClock += 4;
+		profiler.stop();
+
+		TS_ASSERT_EQUALS(profiler.getTime(Common::kProfileEngine), 4u);
+		TS_ASSERT_EQUALS(profiler.getCalls(Common::kProfileResource), 0u);
+	}
+};
@@ -0,0 +1,214 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/memstream.h"
+
+#include "testsystem.h"
+
+/**
+ * Archive with a fixed list of members, each containing the name of the
+ * archive, which counts how often it is searched. Unless it lists all its
+ * members, it also accepts any name starting with "gen".
+ */
+class TestArchive : public Common::Archive {
+public:
+	TestArchive(const char *id, bool listsAll = true) : _id(id), _searches(0), _listsAll(listsAll) {}
+
+	void addMember(const Common::String &name) { _names.push_back(name); }
+
+	virtual bool hasFile(const Common::String &name) const {
+		_searches++;
+		for (uint i = 0; i < _names.size(); ++i) {
+			if (_names[i].equalsIgnoreCase(name))
+				return true;
+		}
+		return !_listsAll && name.hasPrefix("gen");
+	}
+
+	virtual int listMembers(Common::ArchiveMemberList &list) const {
+		for (uint i = 0; i < _names.size(); ++i)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(_names[i], this)));
+		return _names.size();
+	}
+
+	virtual bool listsAllMembers() const { return _listsAll; }
+
+	virtual const Common::ArchiveMemberPtr getMember(const Common::String &name) const {
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(name, this));
+	}
+
+	virtual Common::SeekableReadStream *createReadStreamForMember(const Common::String &name) const {
+		if (!hasFile(name))
+			return 0;
+		return new Common::MemoryReadStream((const byte *)_id, strlen(_id));
+	}
+
+	const char *_id;
+	mutable int _searches;
+	bool _listsAll;
+	Common::Array<Common::String> _names;
+};
+
+class SearchSetTestSuite : public CxxTest::TestSuite
+{
+	static Common::String readMember(const Common::SearchSet &set, const char *name) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(name);
+		if (!stream)
+			return Common::String();
+
+		Common::String content;
+		while (!stream->eos()) {
+			const char c = stream->readByte();
+			if (!stream->eos())
+				content += c;
+		}
+		delete stream;
+		return content;
+	}
+
+	public:
+	void setUp() {
+		TestSystem::install();
+	}
+
+	void test_priority() {
+		TestArchive *low = new TestArchive("low");
+		low->addMember("common.dat");
+		low->addMember("low.dat");
+		TestArchive *high = new TestArchive("high");
+		high->addMember("COMMON.DAT");
+		high->addMember("high.dat");
+
+		Common::SearchSet set;
+		set.add("low", low, 0);
+		set.add("high", high, 1);
+
+		TS_ASSERT_EQUALS(readMember(set, "common.dat"), "high");
+		TS_ASSERT_EQUALS(readMember(set, "Low.Dat"), "low");
+		TS_ASSERT_EQUALS(readMember(set, "high.dat"), "high");
+		TS_ASSERT(set.hasFile("low.dat"));
+		TS_ASSERT(!set.hasFile("missing.dat"));
+		TS_ASSERT(set.getMember("low.dat"));
+		TS_ASSERT(!set.getMember("missing.dat"));
+
+		set.setPriority("low", 2);
+		TS_ASSERT_EQUALS(readMember(set, "common.dat"), "low");
+
+		set.remove("low");
+		TS_ASSERT_EQUALS(readMember(set, "common.dat"), "high");
+		TS_ASSERT(!set.hasFile("low.dat"));
+	}
+
+	void test_index() {
+		TestArchive *a = new TestArchive("a");
+		a->addMember("a.dat");
+		TestArchive *b = new TestArchive("b");
+		b->addMember("b.dat");
+
+		Common::SearchSet set;
+		set.add("a", a, 1);
+		set.add("b", b, 0);
+
+		// Archives not listing a member are not searched for it
+		TS_ASSERT(set.hasFile("b.dat"));
+		TS_ASSERT(!set.hasFile("c.dat"));
+		TS_ASSERT_EQUALS(a->_searches, 0);
+		TS_ASSERT_EQUALS(b->_searches, 1);
+
+		const Common::SearchSet::IndexStats &stats = set.getIndexStats();
+		TS_ASSERT_EQUALS(stats.lookups, 2u);
+		TS_ASSERT_EQUALS(stats.indexed, 2u);
+		TS_ASSERT_EQUALS(stats.probes, 1u);
+		TS_ASSERT_EQUALS(stats.rebuilds, 1u);
+
+		// Paths are looked up in all archives
+		TS_ASSERT(!set.hasFile("sub/b.dat"));
+		TS_ASSERT_EQUALS(a->_searches, 1);
+		TS_ASSERT_EQUALS(stats.lookups, 3u);
+		TS_ASSERT_EQUALS(stats.indexed, 2u);
+
+		set.resetIndexStats();
+		TS_ASSERT_EQUALS(stats.lookups, 0u);
+	}
+
+	void test_unlisted() {
+		TestArchive *listed = new TestArchive("listed");
+		listed->addMember("gen1.dat");
+		listed->addMember("listed.dat");
+		TestArchive *unlisted = new TestArchive("unlisted", false);
+		unlisted->addMember("unlisted.dat");
+
+		Common::SearchSet set;
+		set.add("listed", listed, 0);
+		set.add("unlisted", unlisted, 1);
+		TS_ASSERT(!set.listsAllMembers());
+
+		// Archives not listing all their members are always searched, in
+		// priority order
+		TS_ASSERT_EQUALS(readMember(set, "gen1.dat"), "unlisted");
+		TS_ASSERT_EQUALS(readMember(set, "gen2.dat"), "unlisted");
+		TS_ASSERT_EQUALS(readMember(set, "listed.dat"), "listed");
+		TS_ASSERT(!set.hasFile("missing.dat"));
+		TS_ASSERT_EQUALS(unlisted->_searches, 4);
+		TS_ASSERT_EQUALS(listed->_searches, 1);
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, "*.dat"), 3);
+
+		set.remove("unlisted");
+		TS_ASSERT(set.listsAllMembers());
+		TS_ASSERT_EQUALS(readMember(set, "gen1.dat"), "listed");
+		TS_ASSERT(!set.hasFile("gen2.dat"));
+	}
+
+	void test_nested() {
+		Common::SearchSet inner;
+		Common::SearchSet outer;
+		outer.add("inner", &inner, 0, false);
+		outer.add("other", new TestArchive("other"), 1);
+		outer.remove("other");
+
+		TS_ASSERT(!outer.hasFile("late.dat"));
+
+		// Changes to a nested set must be noticed by the outer one
+		TestArchive *late = new TestArchive("late");
+		late->addMember("late.dat");
+		inner.add("late", late);
+		TS_ASSERT(outer.hasFile("late.dat"));
+		TS_ASSERT_EQUALS(readMember(outer, "late.dat"), "late");
+
+		inner.clear();
+		TS_ASSERT(!outer.hasFile("late.dat"));
+
+		outer.remove("inner");
+	}
+
+	void test_list_matching() {
+		TestArchive *a = new TestArchive("a");
+		a->addMember("intro.smk");
+		a->addMember("music.xmi");
+		TestArchive *b = new TestArchive("b");
+		b->addMember("outro.smk");
+		b->addMember("sub/extra.smk");
+
+		Common::SearchSet set;
+		set.add("a", a, 1);
+		set.add("b", b, 0);
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, "*.SMK"), 2);
+		TS_ASSERT_EQUALS(list.size(), 2u);
+
+		list.clear();
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, "music.xmi"), 1);
+		TS_ASSERT_EQUALS(list.front()->getName(), "music.xmi");
+
+		list.clear();
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, "sub/*.smk"), 1);
+
+		list.clear();
+		TS_ASSERT_EQUALS(set.listMatchingMembers(list, "*.wav"), 0);
+		TS_ASSERT(list.empty());
+	}
+};
@@ -0,0 +1,165 @@
+#ifndef TEST_COMMON_TESTSYSTEM_H
+#define TEST_COMMON_TESTSYSTEM_H
+
+#include "common/system.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/memstream.h"
+#include "common/savefile.h"
+
+#include "graphics/palette.h"
+#include "graphics/pixelformat.h"
+
+#include "audio/mixer_intern.h"
+
+#include "backends/fs/posix/posix-fs-factory.h"
+
+/**
+ * Save file manager keeping all savefiles in memory.
+ */
+class TestSaveFileManager : public Common::SaveFileManager {
+public:
+	typedef Common::HashMap<Common::String, Common::String> FileMap;
+
+	/** The contents of all savefiles, stored in strings. */
+	FileMap _files;
+
+	Common::OutSaveFile *openForSaving(const Common::String &name, bool compress = true) {
+		return new SaveFile(*this, name);
+	}
+
+	Common::InSaveFile *openForLoading(const Common::String &name) {
+		if (!_files.contains(name))
+			return 0;
+
+		const Common::String &data = _files[name];
+		byte *copy = (byte *)malloc(MAX<uint>(data.size(), 1));
+		memcpy(copy, data.c_str(), data.size());
+		return new Common::MemoryReadStream(copy, data.size(), DisposeAfterUse::YES);
+	}
+
+	bool removeSavefile(const Common::String &name) {
+		if (!_files.contains(name))
+			return false;
+		_files.erase(name);
+		return true;
+	}
+
+	Common::StringArray listSavefiles(const Common::String &pattern) {
+		Common::StringArray list;
+		for (FileMap::const_iterator i = _files.begin(); i != _files.end(); ++i) {
+			if (i->_key.matchString(pattern, true))
+				list.push_back(i->_key);
+		}
+		return list;
+	}
+
+private:
+	class SaveFile : public Common::MemoryWriteStreamDynamic {
+	public:
+		SaveFile(TestSaveFileManager &manager, const Common::String &name)
+			: Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES), _manager(manager), _name(name) {}
+
+		~SaveFile() {
+			_manager._files[_name] = Common::String((const char *)getData(), size());
+		}
+
+	private:
+		TestSaveFileManager &_manager;
+		const Common::String _name;
+	};
+};
+
+/**
+ * Palette manager which only stores the palette.
+ */
+class TestPaletteManager : public PaletteManager {
+public:
+	byte _palette[256 * 3];
+
+	TestPaletteManager() { memset(_palette, 0, sizeof(_palette)); }
+
+	void setPalette(const byte *colors, uint start, uint num) { memcpy(_palette + start * 3, colors, num * 3); }
+	void grabPalette(byte *colors, uint start, uint num) { memcpy(colors, _palette + start * 3, num * 3); }
+};
+
+/**
+ * Minimal OSystem for tests of code which needs g_system. It provides
+ * POSIX file system nodes, savefiles kept in memory, no-op mutexes and a
+ * clock which only advances when asked to. There is no screen, the palette
+ * is only stored, the mixer is never ready and there is no timer manager.
+ */
+class TestSystem : public OSystem {
+public:
+	uint32 _millis;
+	/** The format returned by getScreenFormat(), CLUT8 by default. */
+	Graphics::PixelFormat _screenFormat;
+	TestPaletteManager _paletteManager;
+	Audio::MixerImpl *_mixer;
+
+	TestSystem() : _millis(0), _screenFormat(Graphics::PixelFormat::createFormatCLUT8()), _mixer(0) {
+		_fsFactory = new POSIXFilesystemFactory();
+		_savefileManager = new TestSaveFileManager();
+	}
+
+	/** Install a TestSystem as g_system, unless one is installed already. */
+	static TestSystem *install() {
+		if (!g_system)
+			g_system = new TestSystem();
+		return (TestSystem *)g_system;
+	}
+
+	TestSaveFileManager *getTestSavefileManager() { return (TestSaveFileManager *)_savefileManager; }
+
+	const GraphicsMode *getSupportedGraphicsModes() const {
+		static const GraphicsMode modes[] = { { 0, 0, 0 } };
+		return modes;
+	}
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return true; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return _screenFormat; }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return &_paletteManager; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return 0; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	void clearOverlay() {}
+	void grabOverlay(void *buf, int pitch) {}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool visible) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+
+	uint32 getMillis() { return _millis; }
+	void delayMillis(uint msecs) { _millis += msecs; }
+	void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+
+	MutexRef createMutex() { return (MutexRef)this; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+
+	Audio::Mixer *getMixer() {
+		// Created on demand, since its mutex needs g_system
+		if (!_mixer)
+			_mixer = new Audio::MixerImpl(this, 22050);
+		return _mixer;
+	}
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+#endif
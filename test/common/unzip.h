@@ -0,0 +1,277 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/array.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+#include "common/zlib.h"
+
+#include "testsystem.h"
+
+#include <stdio.h>
+
+#ifdef USE_ZLIB
+
+/**
+ * Builds a ZIP archive in memory. Members are stored, or compressed with
+ * the raw deflate data taken from a gzip stream.
+ */
+class TestZipWriter {
+	struct Entry {
+		Common::String name;
+		uint16 method;
+		uint32 crc;
+		uint32 compressedSize;
+		uint32 size;
+		uint32 offset;
+	};
+
+	Common::MemoryWriteStreamDynamic _data;
+	Common::Array<Entry> _entries;
+
+public:
+	TestZipWriter() : _data(DisposeAfterUse::NO) {}
+
+	/** Return raw deflate data, its CRC and its size. */
+	static byte *deflate(const Common::Array<byte> &content, uint32 &crc, uint32 &size) {
+		Common::MemoryWriteStreamDynamic *gzipData = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(gzipData);
+		gzip->write(content.begin(), content.size());
+		gzip->finalize();
+
+		// Strip the 10 byte header and the trailer holding the CRC and size
+		byte *data = gzipData->getData();
+		size = gzipData->size() - 18;
+		crc = READ_LE_UINT32(data + gzipData->size() - 8);
+		memmove(data, data + 10, size);
+		delete gzip;
+		return data;
+	}
+
+	void add(const Common::String &name, const Common::Array<byte> &content, bool compress) {
+		Entry entry;
+		entry.name = name;
+		entry.method = compress ? 8 : 0;
+		entry.size = content.size();
+		entry.offset = _data.pos();
+
+		byte *compressed = deflate(content, entry.crc, entry.compressedSize);
+		if (!compress)
+			entry.compressedSize = entry.size;
+
+		_data.writeUint32LE(0x04034b50);
+		_data.writeUint16LE(20);
+		_data.writeUint16LE(0);
+		_data.writeUint16LE(entry.method);
+		_data.writeUint32LE(0);
+		_data.writeUint32LE(entry.crc);
+		_data.writeUint32LE(entry.compressedSize);
+		_data.writeUint32LE(entry.size);
+		_data.writeUint16LE(name.size());
+		_data.writeUint16LE(0);
+		_data.writeString(name);
+		if (compress)
+			_data.write(compressed, entry.compressedSize);
+		else
+			_data.write(content.begin(), content.size());
+
+		free(compressed);
+		_entries.push_back(entry);
+	}
+
+	/** Write the central directory and return the archive data. */
+	Common::SeekableReadStream *finish() {
+		const uint32 directoryOffset = _data.pos();
+		for (uint i = 0; i < _entries.size(); ++i) {
+			const Entry &entry = _entries[i];
+			_data.writeUint32LE(0x02014b50);
+			_data.writeUint16LE(20);
+			_data.writeUint16LE(20);
+			_data.writeUint16LE(0);
+			_data.writeUint16LE(entry.method);
+			_data.writeUint32LE(0);
+			_data.writeUint32LE(entry.crc);
+			_data.writeUint32LE(entry.compressedSize);
+			_data.writeUint32LE(entry.size);
+			_data.writeUint16LE(entry.name.size());
+			_data.writeUint32LE(0);
+			_data.writeUint32LE(0);
+			_data.writeUint32LE(0);
+			_data.writeUint32LE(entry.offset);
+			_data.writeString(entry.name);
+		}
+		const uint32 directorySize = _data.pos() - directoryOffset;
+
+		_data.writeUint32LE(0x06054b50);
+		_data.writeUint32LE(0);
+		_data.writeUint16LE(_entries.size());
+		_data.writeUint16LE(_entries.size());
+		_data.writeUint32LE(directorySize);
+		_data.writeUint32LE(directoryOffset);
+		_data.writeUint16LE(0);
+
+		return new Common::MemoryReadStream(_data.getData(), _data.size(), DisposeAfterUse::YES);
+	}
+};
+
+#endif
+
+class UnzipTestSuite : public CxxTest::TestSuite
+{
+	static Common::Array<byte> makeContent(uint32 size, uint32 seed) {
+		Common::Array<byte> content;
+		content.resize(size);
+		uint32 random = seed;
+		for (uint32 i = 0; i < size; ++i) {
+			// Runs of pseudo random length, so the data can be compressed
+			if ((i & 15) == 0)
+				random = random * 1103515245 + 12345;
+			content[i] = (byte)((random >> 16) + (i & 3));
+		}
+		return content;
+	}
+
+	/**
+	 * Read the given number of bytes from the stream and compare them with
+	 * the content at the current position of the stream.
+	 */
+	static bool readMatches(Common::SeekableReadStream *stream, const Common::Array<byte> &content, uint32 size) {
+		byte buffer[1024];
+		const uint32 pos = stream->pos();
+		if (stream->read(buffer, size) != size)
+			return false;
+		return !memcmp(buffer, content.begin() + pos, size);
+	}
+
+public:
+	void setUp() {
+		TestSystem::install();
+	}
+
+	// The generated runner calls every test, so they are declared in all
+	// builds and only do something with zlib
+
+	void test_interleaved_members() {
+#ifdef USE_ZLIB
+		const Common::Array<byte> stored = makeContent(10000, 1);
+		const Common::Array<byte> small = makeContent(20000, 2);
+		const Common::Array<byte> large = makeContent(300 * 1024, 3);
+
+		TestZipWriter writer;
+		writer.add("stored.dat", stored, false);
+		writer.add("small.dat", small, true);
+		writer.add("large.dat", large, true);
+		Common::Archive *archive = Common::makeZipArchive(writer.finish());
+		TS_ASSERT(archive);
+
+		// Members are read from the archive on demand, except for small
+		// compressed ones, and several of them may be read at the same time
+		Common::SeekableReadStream *streams[3];
+		const Common::Array<byte> *contents[3] = { &stored, &small, &large };
+		streams[0] = archive->createReadStreamForMember("stored.dat");
+		streams[1] = archive->createReadStreamForMember("small.dat");
+		streams[2] = archive->createReadStreamForMember("large.dat");
+		for (int i = 0; i < 3; ++i) {
+			TS_ASSERT(streams[i]);
+			TS_ASSERT_EQUALS((uint32)streams[i]->size(), contents[i]->size());
+		}
+
+		// The member streams may outlive the archive
+		delete archive;
+
+		uint32 chunk = 1;
+		for (int round = 0; round < 200; ++round) {
+			for (int i = 0; i < 3; ++i) {
+				const uint32 size = MIN<uint32>(chunk, streams[i]->size() - streams[i]->pos());
+				TS_ASSERT(readMatches(streams[i], *contents[i], size));
+			}
+			chunk = (chunk * 7 + 3) % 1000;
+		}
+
+		// Seeking backwards, also into the data already decompressed
+		for (int i = 0; i < 3; ++i) {
+			TS_ASSERT(streams[i]->seek(-1000, SEEK_END));
+			TS_ASSERT(readMatches(streams[i], *contents[i], 1000));
+			TS_ASSERT(!streams[i]->eos());
+			TS_ASSERT_EQUALS(streams[i]->readByte(), 0);
+			TS_ASSERT(streams[i]->eos());
+
+			TS_ASSERT(streams[i]->seek(123, SEEK_SET));
+			TS_ASSERT(readMatches(streams[i], *contents[i], 500));
+			TS_ASSERT(streams[i]->seek(-200, SEEK_CUR));
+			TS_ASSERT(readMatches(streams[i], *contents[i], 1000));
+			delete streams[i];
+		}
+#endif
+	}
+
+	void test_archive_file() {
+#ifdef USE_ZLIB
+		const Common::Array<byte> stored = makeContent(5000, 5);
+		const Common::Array<byte> compressed = makeContent(5000, 6);
+
+		TestZipWriter writer;
+		writer.add("stored.dat", stored, false);
+		writer.add("compressed.dat", compressed, true);
+		Common::SeekableReadStream *data = writer.finish();
+
+		Common::FSNode node = Common::FSNode(".").getChild("unzip.tmp");
+		Common::WriteStream *file = node.createWriteStream();
+		byte buffer[1024];
+		while (uint32 size = data->read(buffer, sizeof(buffer)))
+			file->write(buffer, size);
+		file->finalize();
+		delete file;
+		delete data;
+
+		// The archive file is memory mapped where this is supported
+		Common::Archive *archive = Common::makeZipArchive(Common::FSNode(".").getChild("unzip.tmp"));
+		TS_ASSERT(archive);
+
+		Common::SeekableReadStream *stream = archive->createReadStreamForMember("stored.dat");
+		TS_ASSERT(readMatches(stream, stored, 1000));
+		TS_ASSERT(stream->seek(-1000, SEEK_END));
+		TS_ASSERT(readMatches(stream, stored, 1000));
+		delete stream;
+
+		stream = archive->createReadStreamForMember("compressed.dat");
+		TS_ASSERT_EQUALS((uint32)stream->size(), compressed.size());
+		TS_ASSERT(readMatches(stream, compressed, 1000));
+		delete stream;
+
+		delete archive;
+		remove(node.getPath().c_str());
+#endif
+	}
+
+	void test_deflate_stream() {
+#ifdef USE_ZLIB
+		const Common::Array<byte> content = makeContent(50000, 4);
+		uint32 crc, compressedSize;
+		byte *compressed = TestZipWriter::deflate(content, crc, compressedSize);
+		TS_ASSERT(compressedSize < content.size());
+
+		// Raw deflate data does not contain its size, the given one is used
+		Common::SeekableReadStream *stream = Common::wrapDeflateReadStream(
+			new Common::MemoryReadStream(compressed, compressedSize, DisposeAfterUse::YES), content.size());
+		TS_ASSERT(stream);
+		TS_ASSERT_EQUALS((uint32)stream->size(), content.size());
+
+		for (uint32 pos = 0; pos < content.size(); pos += 1000)
+			TS_ASSERT(readMatches(stream, content, 1000));
+		TS_ASSERT(!stream->eos());
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+
+		TS_ASSERT(stream->seek(-300, SEEK_END));
+		TS_ASSERT_EQUALS(stream->pos(), 49700);
+		TS_ASSERT(readMatches(stream, content, 300));
+
+		TS_ASSERT(stream->seek(10, SEEK_SET));
+		TS_ASSERT(readMatches(stream, content, 1000));
+
+		delete stream;
+#endif
+	}
+};
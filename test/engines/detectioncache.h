@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/detectioncache.h"
+
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/stream.h"
+
+#include "../common/testsystem.h"
+
+#include <stdio.h>
+
+class DetectionCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	TestSystem *_system;
+
+	/** Write a file of the given size into the current directory. */
+	Common::FSNode writeFile(const char *name, uint32 size, byte seed) {
+		Common::FSNode node = Common::FSNode(".").getChild(name);
+		Common::WriteStream *stream = node.createWriteStream();
+		TS_ASSERT(stream);
+		for (uint32 i = 0; i < size; ++i)
+			stream->writeByte((byte)(i * 7 + seed));
+		stream->finalize();
+		delete stream;
+
+		// Nodes keep the size and modification time they saw first
+		return Common::FSNode(".").getChild(name);
+	}
+
+	Common::String computeMD5(const Common::FSNode &node, uint32 md5Bytes) {
+		Common::SeekableReadStream *stream = node.createReadStream();
+		Common::String md5 = Common::computeStreamMD5AsString(*stream, md5Bytes);
+		delete stream;
+		return md5;
+	}
+
+public:
+	void setUp() {
+		_system = TestSystem::install();
+	}
+
+	void test_cache_hit() {
+		Common::FSNode node = writeFile("detectioncache-hit.tmp", 10000, 1);
+		DetectionCache &cache = DetectionCache::instance();
+
+		int32 size;
+		Common::String md5;
+		cache.beginScan();
+
+		TS_ASSERT(cache.getFileProperties(node, 5000, size, md5));
+		TS_ASSERT_EQUALS(size, 10000);
+		TS_ASSERT_EQUALS(md5, computeMD5(node, 5000));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 0u);
+		TS_ASSERT_EQUALS(cache.getStats().bytesHashed, 5000u);
+
+		// The same file for another engine is served from the cache
+		TS_ASSERT(cache.getFileProperties(node, 5000, size, md5));
+		TS_ASSERT_EQUALS(size, 10000);
+		TS_ASSERT_EQUALS(md5, computeMD5(node, 5000));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 1u);
+		TS_ASSERT_EQUALS(cache.getStats().bytesHashed, 5000u);
+
+		// Checksums of a different length are cached separately
+		TS_ASSERT(cache.getFileProperties(node, 0, size, md5));
+		TS_ASSERT_EQUALS(md5, computeMD5(node, 0));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 1u);
+		TS_ASSERT_EQUALS(cache.getStats().bytesHashed, 15000u);
+
+		cache.endScan();
+		TS_ASSERT_EQUALS(cache.getStats().files, 3u);
+
+		// The index is written when the scan ends, and the next scan
+		// still finds the file in the cache
+		TS_ASSERT(_system->getTestSavefileManager()->_files.contains("detection.idx"));
+
+		cache.beginScan();
+		TS_ASSERT(cache.getFileProperties(node, 5000, size, md5));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 1u);
+		TS_ASSERT_EQUALS(cache.getStats().bytesHashed, 0u);
+		cache.endScan();
+
+		remove(node.getPath().c_str());
+	}
+
+	void test_invalidation() {
+		Common::FSNode node = writeFile("detectioncache-change.tmp", 3000, 2);
+		DetectionCache &cache = DetectionCache::instance();
+
+		int32 size;
+		Common::String md5;
+		cache.beginScan();
+		TS_ASSERT(cache.getFileProperties(node, 0, size, md5));
+		TS_ASSERT_EQUALS(size, 3000);
+		cache.endScan();
+
+		// A file with a different size is hashed again, even if the
+		// modification time did not change within its resolution
+		node = writeFile("detectioncache-change.tmp", 4000, 3);
+
+		cache.beginScan();
+		TS_ASSERT(cache.getFileProperties(node, 0, size, md5));
+		TS_ASSERT_EQUALS(size, 4000);
+		TS_ASSERT_EQUALS(md5, computeMD5(node, 0));
+		TS_ASSERT_EQUALS(cache.getStats().hits, 0u);
+		TS_ASSERT_EQUALS(cache.getStats().bytesHashed, 4000u);
+		cache.endScan();
+
+		remove(node.getPath().c_str());
+	}
+
+	void test_missing_file() {
+		Common::FSNode node = Common::FSNode(".").getChild("detectioncache-missing.tmp");
+		DetectionCache &cache = DetectionCache::instance();
+
+		int32 size;
+		Common::String md5;
+		cache.beginScan();
+		TS_ASSERT(!cache.getFileProperties(node, 0, size, md5));
+		cache.endScan();
+	}
+};
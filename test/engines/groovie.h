@@ -0,0 +1,135 @@
+#include <cxxtest/TestSuite.h>
+
+#include "base/plugins.h"
+
+// Only built with ENGINE_TESTS, for the engine linked as a static plugin
+#if defined(ENGINE_TESTS) && PLUGIN_ENABLED_STATIC(GROOVIE)
+#define GROOVIE_TESTS
+
+#include "groovie/cell.h"
+
+#include "../common/testsystem.h"
+
+#endif
+
+class GroovieTestSuite : public CxxTest::TestSuite
+{
+#ifdef GROOVIE_TESTS
+	// The cell values of the script variables holding the board
+	enum {
+		kScriptClear = 0,
+		kScriptBlue = 50,
+		kScriptGreen = 66
+	};
+
+	static uint32 addToChecksum(uint32 checksum, uint32 value) {
+		return (checksum ^ value) * 16777619;
+	}
+
+	static uint32 addMoveToChecksum(uint32 checksum, Groovie::CellGame &game) {
+		checksum = addToChecksum(checksum, game.getStartX());
+		checksum = addToChecksum(checksum, game.getStartY());
+		checksum = addToChecksum(checksum, game.getEndX());
+		return addToChecksum(checksum, game.getEndY());
+	}
+
+	/**
+	 * Let Stauf play both colors from the start position with the given
+	 * depth, and return a checksum of all moves.
+	 */
+	static uint32 playGameChecksum(uint16 depth) {
+		Groovie::CellGame game;
+		byte board[49];
+		memset(board, kScriptClear, sizeof(board));
+		board[0] = board[48] = kScriptBlue;
+		board[6] = board[42] = kScriptGreen;
+
+		uint32 checksum = 2166136261u;
+		for (int move = 0; move < 100; move++) {
+			const byte color = (move & 1) ? CELL_BLUE : CELL_GREEN;
+			const byte cell = (color == CELL_BLUE) ? kScriptBlue : kScriptGreen;
+
+			checksum = addToChecksum(checksum, game.playStauf(color, depth, board));
+			checksum = addMoveToChecksum(checksum, game);
+
+			// The game is over when no valid move was returned
+			const int startX = game.getStartX(), startY = game.getStartY();
+			const int endX = game.getEndX(), endY = game.getEndY();
+			const int distance = MAX(ABS(endX - startX), ABS(endY - startY));
+			if (board[startY * 7 + startX] != cell || board[endY * 7 + endX] != kScriptClear || distance < 1 || distance > 2)
+				break;
+
+			// Cells move two steps and are cloned one step, and take the
+			// cells around their destination
+			if (distance == 2)
+				board[startY * 7 + startX] = kScriptClear;
+			for (int y = MAX(endY - 1, 0); y <= MIN(endY + 1, 6); y++) {
+				for (int x = MAX(endX - 1, 0); x <= MIN(endX + 1, 6); x++) {
+					if (board[y * 7 + x] != kScriptClear)
+						board[y * 7 + x] = cell;
+				}
+			}
+			board[endY * 7 + endX] = cell;
+		}
+		return checksum;
+	}
+
+	/**
+	 * Let Stauf find moves for pseudo random boards of varying density with
+	 * the given depth, and return a checksum of all moves.
+	 */
+	static uint32 randomBoardsChecksum(uint16 depth, int count) {
+		Groovie::CellGame game;
+		byte board[49];
+		uint32 random = depth + 1;
+
+		uint32 checksum = 2166136261u;
+		for (int i = 0; i < count; i++) {
+			const uint32 density = 2 + i % 14;
+			for (int j = 0; j < 49; j++) {
+				random = random * 1103515245 + 12345;
+				const uint32 value = (random >> 16) & 15;
+				if (value >= density)
+					board[j] = kScriptClear;
+				else
+					board[j] = (value & 1) ? kScriptBlue : kScriptGreen;
+			}
+
+			checksum = addToChecksum(checksum, game.playStauf((i & 1) ? CELL_BLUE : CELL_GREEN, depth, board));
+			checksum = addMoveToChecksum(checksum, game);
+		}
+		return checksum;
+	}
+#endif
+
+public:
+	// The expected checksums were recorded with CellGame before its search
+	// results were memoized. Every depth the scripts can ask for is played.
+
+	void test_stauf_games() {
+#ifdef GROOVIE_TESTS
+		TestSystem::install();
+
+		static const uint32 expected[] = {
+			4278858957u, 3206838611u, 3670955260u, 771314319u, 733330850u,
+			2608813252u, 4020782018u, 3699367067u, 217185632u
+		};
+		for (uint16 depth = 0; depth < ARRAYSIZE(expected); depth++)
+			TSM_ASSERT_EQUALS(Common::String::format("Depth %d", depth).c_str(), playGameChecksum(depth), expected[depth]);
+#endif
+	}
+
+	void test_stauf_random_boards() {
+#ifdef GROOVIE_TESTS
+		TestSystem::install();
+
+		static const uint32 expected[] = {
+			2631215574u, 1172010204u, 120842975u, 1314176755u, 3737734195u,
+			305770717u, 2044104077u, 473959266u, 2849066853u
+		};
+		// Deeper searches take much longer, so they get fewer boards
+		for (uint16 depth = 0; depth < ARRAYSIZE(expected); depth++)
+			TSM_ASSERT_EQUALS(Common::String::format("Depth %d", depth).c_str(), randomBoardsChecksum(depth, (depth < 6) ? 200 : 20), expected[depth]);
+#endif
+	}
+};
@@ -0,0 +1,183 @@
+#include <cxxtest/TestSuite.h>
+
+#include "base/plugins.h"
+
+// Only built with ENGINE_TESTS, for the engine linked as a static plugin
+#if defined(ENGINE_TESTS) && PLUGIN_ENABLED_STATIC(KYRA)
+#define KYRA_TESTS
+
+#include "kyra/kyra_v1.h"
+#include "kyra/screen_v2.h"
+
+#include "../common/testsystem.h"
+
+/**
+ * Engine without game data, only providing what the screen needs.
+ */
+class TestKyraEngine : public Kyra::KyraEngine_v1 {
+public:
+	TestKyraEngine(OSystem *system, const Kyra::GameFlags &flags) : Kyra::KyraEngine_v1(system, flags) {}
+
+	Kyra::Screen *screen() { return 0; }
+	void snd_playVoiceFile(int id) {}
+
+protected:
+	Common::Error go() { return Common::kNoError; }
+	void setupTimers() {}
+	void setWalkspeed(uint8 speed) {}
+	void setupOpcodeTable() {}
+	void setHandItem(Kyra::Item item) {}
+	void removeHandItem() {}
+	bool lineIsPassable(int x, int y) { return true; }
+	Common::Error loadGameState(int slot) { return Common::kNoError; }
+	Common::Error saveGameStateIntern(int slot, const char *saveName, const Graphics::Surface *thumbnail) { return Common::kNoError; }
+};
+
+#endif
+
+class KyraTestSuite : public CxxTest::TestSuite
+{
+#ifdef KYRA_TESTS
+	uint8 _table[256], _table2[256], _table3[256], _table5[256];
+	uint8 _table4[16 * 256];
+
+	/**
+	 * Draw a shape with the given line function and plot type. drawShape()
+	 * only reads the arguments for the flags which are set, in this order.
+	 */
+	void drawShape(Kyra::Screen &screen, const uint8 *shape, int x, int y, int sd, int drawFunc, int plotType) {
+		const int flags = drawFunc | (plotType << 8) | 0x8000 | 0x4000;
+		const int w = 0x40 + drawFunc * 0x30;
+		const int h = 0x180 - drawFunc * 0x28;
+		const bool scale = (drawFunc & Kyra::Screen::DSF_SCALE) != 0;
+
+		switch (plotType) {
+		case 0: case 4: case 6:
+			screen.drawShape(0, shape, x, y, sd, flags, _table2, 0x80, w, h);
+			break;
+		case 1: case 3: case 5: case 7:
+			screen.drawShape(0, shape, x, y, sd, flags, _table2, _table, 2, 0x80, w, h);
+			break;
+		case 8: case 12: case 14:
+			screen.drawShape(0, shape, x, y, sd, flags, _table2, 0x80, 3, w, h);
+			break;
+		case 9: case 11: case 13: case 15:
+			screen.drawShape(0, shape, x, y, sd, flags, _table2, _table, 2, 0x80, 3, w, h);
+			break;
+		case 16: case 20:
+			screen.drawShape(0, shape, x, y, sd, flags, _table2, _table3, _table4, 0x80, w, h);
+			break;
+		case 21:
+			screen.drawShape(0, shape, x, y, sd, flags, _table2, _table, 2, _table3, _table4, 0x80, w, h);
+			break;
+		case 33: case 37:
+			if (scale)
+				screen.drawShape(0, shape, x, y, sd, flags, _table2, _table, 2, 0x80, w, h, _table5);
+			else
+				screen.drawShape(0, shape, x, y, sd, flags, _table2, _table, 2, 0x80, _table5);
+			break;
+		case 48: case 52:
+			if (scale)
+				screen.drawShape(0, shape, x, y, sd, flags, _table2, _table3, _table4, 0x80, w, h, _table5);
+			else
+				screen.drawShape(0, shape, x, y, sd, flags, _table2, _table3, _table4, 0x80, _table5);
+			break;
+		}
+	}
+
+	/**
+	 * Draw shapes with all line functions and many plot types into a
+	 * screen of the given game, and return a checksum of the drawn page.
+	 */
+	uint32 drawShapesChecksum(byte gameID) {
+		TestSystem::install();
+
+		Kyra::GameFlags flags;
+		memset(&flags, 0, sizeof(flags));
+		flags.lang = Common::EN_ANY;
+		flags.platform = Common::kPlatformDOS;
+		flags.gameID = gameID;
+		TestKyraEngine vm(g_system, flags);
+
+		static const Kyra::ScreenDim dims[] = {
+			{ 0x00, 0x00, 0x28, 0xC8, 0x0F, 0x0C, 0x00, 0x00 },
+			{ 0x04, 0x10, 0x20, 0x80, 0x0F, 0x0C, 0x00, 0x00 }
+		};
+		Kyra::Screen_v2 screen(&vm, g_system, dims, ARRAYSIZE(dims));
+		TS_ASSERT(screen.init());
+
+		// The shape source with transparent runs, and the layer masks for
+		// the plot types which draw behind other objects
+		uint8 *buffer = new uint8[Kyra::Screen::SCREEN_W * Kyra::Screen::SCREEN_H];
+		uint32 random = 12345;
+		for (int page = 2; page <= 6; page += 2) {
+			for (int i = 0; i < Kyra::Screen::SCREEN_W * Kyra::Screen::SCREEN_H; ++i) {
+				if ((i & 7) == 0)
+					random = random * 1103515245 + 12345;
+				buffer[i] = (random & 0x30000) ? (byte)((random >> 20) + (i & 3)) : 0;
+			}
+			screen.copyBlockToPage(page, 0, 0, Kyra::Screen::SCREEN_W, Kyra::Screen::SCREEN_H, buffer);
+		}
+		delete[] buffer;
+		screen.setShapePages(4, 6);
+
+		screen.setCurPage(2);
+		uint8 *shape = screen.encodeShape(8, 4, 61, 37, 0);
+		// Shapes with a color table always use it as the first table
+		uint8 *tableShape = screen.encodeShape(100, 60, 40, 29, 1);
+
+		for (int i = 0; i < 256; ++i) {
+			_table[i] = (i * 7) & 0xFF;
+			_table2[i] = (i == 17) ? 255 : 255 - i;
+			_table3[i] = (i & 0x10) ? 0x80 : (i & 0x0F);
+			_table5[i] = i ^ 0x55;
+		}
+		for (int i = 0; i < ARRAYSIZE(_table4); ++i)
+			_table4[i] = (i * 13) >> 4;
+
+		static const int plotTypes[] = {
+			0, 1, 3, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16, 20, 21, 33, 37, 48, 52
+		};
+
+		uint32 checksum = 2166136261u;
+		for (int i = 0; i < ARRAYSIZE(plotTypes); ++i) {
+			// Kyra 1 does not pass the table for the types which need it
+			if (gameID == Kyra::GI_KYRA1 && (plotTypes[i] == 33 || plotTypes[i] == 37))
+				continue;
+
+			for (int drawFunc = 0; drawFunc < 8; ++drawFunc) {
+				const int x = (i * 37 + drawFunc * 11) % 320 - 20;
+				const int y = (i * 23 + drawFunc * 17) % 200 - 10;
+				// The plot types with 0x400 skip the color table of the shape
+				if (!(plotTypes[i] & 4))
+					drawShape(screen, shape, x, y, (drawFunc & 2) >> 1, drawFunc, plotTypes[i]);
+				drawShape(screen, tableShape, y, x, 0, drawFunc, plotTypes[i]);
+			}
+
+			const uint8 *page = screen.getCPagePtr(0);
+			for (int j = 0; j < Kyra::Screen::SCREEN_W * Kyra::Screen::SCREEN_H; ++j)
+				checksum = (checksum ^ page[j]) * 16777619;
+		}
+
+		delete[] shape;
+		delete[] tableShape;
+		return checksum;
+	}
+#endif
+
+public:
+	// The expected checksums were recorded with drawShape() before its line
+	// functions were specialized for the common plot types.
+
+	void test_draw_shape_kyra1() {
+#ifdef KYRA_TESTS
+		TS_ASSERT_EQUALS(drawShapesChecksum(Kyra::GI_KYRA1), 2393718842u);
+#endif
+	}
+
+	void test_draw_shape_lol() {
+#ifdef KYRA_TESTS
+		TS_ASSERT_EQUALS(drawShapesChecksum(Kyra::GI_LOL), 1673831731u);
+#endif
+	}
+};
@@ -0,0 +1,81 @@
+#include <cxxtest/TestSuite.h>
+
+#include "base/plugins.h"
+
+// Only built with ENGINE_TESTS, for the engine linked as a static plugin
+#if defined(ENGINE_TESTS) && PLUGIN_ENABLED_STATIC(SWORD25)
+#define SWORD25_TESTS
+
+#include "sword25/gfx/bitmap.h"
+#include "sword25/gfx/graphicengine.h"
+#include "sword25/gfx/panel.h"
+#include "sword25/kernel/kernel.h"
+
+#include "../common/testsystem.h"
+
+#endif
+
+class Sword25TestSuite : public CxxTest::TestSuite
+{
+#ifdef SWORD25_TESTS
+	Sword25::GraphicEngine *_gfx;
+
+	/** Return the pixel at the given position of the back surface. */
+	uint32 getPixel(int x, int y) {
+		return *(const uint32 *)_gfx->getSurface()->getBasePtr(x, y);
+	}
+
+	void drawFrame() {
+		_gfx->startFrame();
+		_gfx->endFrame();
+	}
+
+public:
+	void setUp() {
+		TestSystem *system = TestSystem::install();
+		system->_screenFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24);
+
+		_gfx = Sword25::Kernel::getInstance()->getGfx();
+		TS_ASSERT(_gfx->init(64, 64, 32, 1));
+	}
+
+	void tearDown() {
+		Sword25::Kernel::deleteInstance();
+	}
+#endif
+
+public:
+	void test_dynamic_bitmap_content() {
+#ifdef SWORD25_TESTS
+		// Movie frames are shown with a dynamic bitmap, which does not move
+		// while only its content changes
+		Sword25::RenderObjectPtr<Sword25::Bitmap> bitmap = _gfx->getMainPanel()->addDynamicBitmap(16, 16);
+		TS_ASSERT(bitmap.isValid());
+		bitmap->setPos(8, 8);
+		bitmap->setVisible(true);
+
+		byte content[16 * 16 * 4];
+		memset(content, 0xff, sizeof(content));
+		TS_ASSERT(bitmap->setContent(content, sizeof(content), 0, 16 * 4));
+		drawFrame();
+		const uint32 white = getPixel(12, 12);
+		TS_ASSERT_EQUALS(getPixel(4, 4), 0u);
+		TS_ASSERT_DIFFERS(white, 0u);
+
+		// Opaque, in either byte order of the pixels
+		for (uint i = 0; i < sizeof(content); i += 4) {
+			content[i + 1] = 0x40;
+			content[i + 2] = 0x40;
+		}
+		TS_ASSERT(bitmap->setContent(content, sizeof(content), 0, 16 * 4));
+		drawFrame();
+		TS_ASSERT_DIFFERS(getPixel(12, 12), white);
+		TS_ASSERT_EQUALS(getPixel(12, 12), getPixel(20, 20));
+
+		// Without changes, nothing is drawn again
+		*(uint32 *)_gfx->getSurface()->getBasePtr(12, 12) = 0;
+		drawFrame();
+		TS_ASSERT_EQUALS(getPixel(12, 12), 0u);
+#endif
+	}
+};
@@ -5,8 +5,8 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/engines/*.h
+TEST_LIBS    := engines/libengines.a audio/libaudio.a backends/libbackends.a common/libcommon.a
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
@@ -14,6 +14,14 @@ TEST_CFLAGS  := -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 
+ifdef ENGINE_TESTS
+# Engine tests need the engines, which pull in most of what the executable
+# links. OBJS is only complete once all modules are included. Use
+# 'make test ENGINE_TESTS=1' to run them for the statically linked engines.
+TEST_CFLAGS  += -DENGINE_TESTS
+TEST_LDFLAGS  = -Wl,--start-group $(OBJS) -Wl,--end-group $(LIBS)
+endif
+
 ifdef HAVE_GCC3
 # In test/common/str.h, we test a zero length format string. This causes GCC
 # to generate a warning which in turn poses a problem when building with -Werror.